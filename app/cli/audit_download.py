@@ -0,0 +1,133 @@
+"""
+Téléchargement du journal d'accès persistant (anneau EEPROM du contrôleur).
+
+Chaque réponse "audit" contient au plus quelques enregistrements
+[seq, ts, uid_hash, reader, decision, synced] et un curseur "next".
+Le curseur est sauvegardé après chaque bloc : une reprise ne
+retélécharge que les nouveaux enregistrements.
+
+    python -m cli.audit_download --port /dev/ttyACM0 --out audit.jsonl
+    python -m cli.audit_download --port /dev/ttyACM0 --out audit.jsonl --from-start
+
+uid_hash = FNV-1a 32 bits de l'UID (5 octets) replié sur 16 bits :
+utiliser uid_hash() pour retrouver les badges connus.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+from core.protocol import Protocol
+
+DECISIONS = ("granted", "denied_unknown", "denied_schedule", "denied_clock", "manual_open",
+             "denied_role", "admin_card")
+
+
+def uid_hash(uid: bytes) -> int:
+    """Même calcul que AuditLog::hashUID côté firmware."""
+    h = 2166136261
+    for b in uid:
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return (h >> 16) ^ (h & 0xFFFF)
+
+
+def audit_rows(msg: dict):
+    """Enregistrements d'une réponse "audit", décodés (une ligne JSON chacun)."""
+    for seq, ts, uh, reader, decision, synced in msg.get("records", []):
+        yield {
+            "seq": seq,
+            "ts": ts,
+            "clock": "local" if synced else "uptime",
+            "uid_hash": f"{uh:04X}",
+            "reader": reader,
+            "decision": DECISIONS[decision] if decision < len(DECISIONS) else decision,
+        }
+
+
+# ==================================================
+# CURSEUR DE REPRISE
+# ==================================================
+def load_cursor(path: str):
+    try:
+        with open(path, encoding="utf-8") as f:
+            return int(f.read().strip())
+    except (OSError, ValueError):
+        return None
+
+
+def save_cursor(path: str, cursor: int):
+    tmp = path + ".tmp"
+    with open(tmp, "w", encoding="utf-8") as f:
+        f.write(str(cursor))
+    os.replace(tmp, path)
+
+
+# ==================================================
+# TÉLÉCHARGEMENT
+# ==================================================
+def download(port: str, out_path: str, cursor_path: str, from_start: bool, timeout: float) -> int:
+    from core.serial_link import SerialLink
+
+    link = SerialLink()
+    link.connect(port)
+
+    if not link.wait_connected(5):
+        print("Échec connexion Arduino", file=sys.stderr)
+        return 1
+
+    cursor = None if from_start else load_cursor(cursor_path)
+    total = 0
+    try:
+        with open(out_path, "a", encoding="utf-8") as out:
+            while True:
+                request = Protocol.AUDIT if cursor is None else Protocol.audit_from(cursor)
+                try:
+                    msg = link.send(request, timeout=timeout).result()
+                except (TimeoutError, ConnectionError, RuntimeError):
+                    print("Pas de réponse, reprise possible au curseur sauvegardé", file=sys.stderr)
+                    return 1
+
+                if msg.get("status") != "success":
+                    print(f"Erreur : {msg}", file=sys.stderr)
+                    return 1
+
+                # Curseur écrasé par l'anneau : des enregistrements sont perdus
+                if cursor is not None:
+                    lost = (msg["first"] - cursor) & 0xFFFF
+                    if 0 < lost < 0x8000:
+                        print(f"{lost} enregistrement(s) écrasé(s) avant lecture", file=sys.stderr)
+
+                for row in audit_rows(msg):
+                    out.write(json.dumps(row) + "\n")
+                    total += 1
+                out.flush()
+
+                cursor = msg["next"]
+                save_cursor(cursor_path, cursor)
+                if not msg.get("more"):
+                    break
+    finally:
+        link.stop()
+
+    print(f"{total} enregistrement(s) téléchargé(s), curseur {cursor}")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Téléchargement du journal d'accès")
+    parser.add_argument("--port", required=True, help="port série du contrôleur")
+    parser.add_argument("--out", default="audit.jsonl", help="fichier JSON lines (ajout)")
+    parser.add_argument("--cursor-file", help="curseur de reprise (défaut : <out>.cursor)")
+    parser.add_argument("--from-start", action="store_true",
+                        help="ignorer le curseur sauvegardé")
+    parser.add_argument("--timeout", type=float, default=2.0, help="attente max par bloc (s)")
+    args = parser.parse_args()
+
+    cursor_path = args.cursor_file or args.out + ".cursor"
+    sys.exit(download(args.port, args.out, cursor_path, args.from_start, args.timeout))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+"""
+Hub multi-portes : un seul processus, une seule boucle asyncio pour N contrôleurs.
+
+Serveur (fichier de portes : {"doors": {"entree": "/dev/ttyACM0", ...}}) :
+    python -m cli.hub serve --doors doors.json [--parallel 8] [--log-dir audit]
+
+Client (API locale, socket Unix) :
+    python -m cli.hub list
+    python -m cli.hub stats [--door entree ...]
+    python -m cli.hub send 101 --pin 123 [--door entree ...]
+    python -m cli.hub push badges.json --pin 123
+    python -m cli.hub logs
+    python -m cli.hub events
+"""
+
+import argparse
+import asyncio
+import getpass
+import json
+import signal
+import sys
+
+from core.hub_client import HubClient, DEFAULT_SOCKET
+
+
+# ==================================================
+# SERVEUR
+# ==================================================
+async def serve(doors_path: str, socket_path: str, parallel: int, log_dir: str):
+    from core.hub import Hub
+
+    with open(doors_path, encoding="utf-8") as f:
+        doors = json.load(f)["doors"]
+
+    hub = Hub(doors, max_parallel=parallel, log_dir=log_dir)
+    await hub.start()
+    print(f"Hub : {len(doors)} porte(s), API sur {socket_path}")
+
+    server = asyncio.create_task(hub.serve(socket_path))
+    stop = asyncio.Event()
+    loop = asyncio.get_running_loop()
+    for sig in (signal.SIGINT, signal.SIGTERM):
+        loop.add_signal_handler(sig, stop.set)
+
+    await stop.wait()
+    server.cancel()
+    await hub.stop()
+    print("Hub arrêté")
+
+
+# ==================================================
+# CLIENT
+# ==================================================
+def print_fanout(result: dict):
+    for door, r in sorted(result.items()):
+        if r["ok"]:
+            print(f"{door:<16} ok     {json.dumps(r['result'])}")
+        else:
+            print(f"{door:<16} ÉCHEC  {r['error']}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Hub multi-contrôleurs")
+    parser.add_argument("--socket", default=DEFAULT_SOCKET, help="socket Unix de l'API")
+    sub = parser.add_subparsers(dest="op", required=True)
+
+    p = sub.add_parser("serve", help="lancer le hub")
+    p.add_argument("--doors", required=True, help="fichier JSON nom -> port")
+    p.add_argument("--parallel", type=int, default=8, help="portes traitées en même temps")
+    p.add_argument("--log-dir", default="audit", help="journaux collectés (<porte>.jsonl)")
+
+    sub.add_parser("list", help="portes et état des liens")
+    sub.add_parser("events", help="flux des événements de toutes les portes")
+
+    for name, help_text in (("stats", "stats agrégées"), ("logs", "collecte des journaux d'accès")):
+        p = sub.add_parser(name, help=help_text)
+        p.add_argument("--door", action="append", help="porte ciblée (défaut : toutes)")
+
+    p = sub.add_parser("send", help="même commande sur chaque porte")
+    p.add_argument("cmd")
+    p.add_argument("--pin", help="PIN admin (commandes admin)")
+    p.add_argument("--door", action="append")
+
+    p = sub.add_parser("push", help="jeu de profils badges (rôles, horaires, config)")
+    p.add_argument("badge_set", help="fichier JSON")
+    p.add_argument("--pin", help="PIN admin (demandé si absent)")
+    p.add_argument("--door", action="append")
+
+    args = parser.parse_args()
+
+    if args.op == "serve":
+        asyncio.run(serve(args.doors, args.socket, args.parallel, args.log_dir))
+        return
+
+    client = HubClient(args.socket)
+    try:
+        if args.op == "list":
+            for door, s in sorted(client.list().items()):
+                state = "connecté" if s["connected"] else "hors ligne"
+                print(f"{door:<16} {s['port']:<16} {state:<11} timeouts={s['timeouts']} "
+                      f"reconnexions={s['reconnects']}")
+        elif args.op == "stats":
+            result = client.stats(args.door)
+            print(json.dumps(result["summary"], indent=2))
+            print_fanout({d: r if not r["ok"] else {"ok": True, "result": "ok"}
+                          for d, r in result["doors"].items()})
+        elif args.op == "send":
+            print_fanout(client.send(args.cmd, args.door, args.pin))
+        elif args.op == "push":
+            with open(args.badge_set, encoding="utf-8") as f:
+                badge_set = json.load(f)
+            pin = args.pin or getpass.getpass("PIN admin : ")
+            print_fanout(client.push(badge_set, pin, args.door))
+        elif args.op == "logs":
+            print_fanout(client.collect_logs(args.door))
+        elif args.op == "events":
+            for event in client.events():
+                print(json.dumps(event))
+    except (OSError, RuntimeError) as e:
+        print(f"Hub : {e}", file=sys.stderr)
+        sys.exit(1)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
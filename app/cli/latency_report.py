@@ -0,0 +1,137 @@
+"""
+Agrégation des traces de latence badge -> relais.
+
+Le firmware ajoute un champ optionnel "trace" aux événements "badge" et
+"open_door" : offsets en microsecondes depuis la détection de la carte
+(detect, uid, lookup, open_door, relay).
+
+Sources possibles :
+    python -m cli.latency_report --port /dev/ttyACM0 [--duration 60]
+    python -m cli.latency_report --file session.jsonl   (session enregistrée / simulée)
+    ... | python -m cli.latency_report --file -
+"""
+
+import argparse
+import json
+import sys
+import time
+
+STAGES = ("detect", "uid", "lookup", "open_door", "relay")
+
+
+# ==================================================
+# AGRÉGATION
+# ==================================================
+class TraceAggregator:
+    def __init__(self):
+        # étape -> liste d'offsets (us)
+        self.samples = {s: [] for s in STAGES}
+        self.badges = 0
+        self.opens = 0
+
+    def feed(self, msg: dict):
+        trace = msg.get("trace")
+        if not isinstance(trace, dict):
+            return
+
+        if msg.get("type") == "badge":
+            self.badges += 1
+        elif msg.get("action") == "open_door":
+            self.opens += 1
+        else:
+            return
+
+        for stage, value in trace.items():
+            if stage in self.samples and isinstance(value, (int, float)):
+                # Les étapes amont sont répétées dans open_door : ne garder
+                # que celles propres à l'événement pour éviter les doublons
+                if msg.get("action") == "open_door" and stage in ("detect", "uid", "lookup"):
+                    continue
+                self.samples[stage].append(value)
+
+    @staticmethod
+    def percentile(values: list, pct: float) -> float:
+        """Nearest-rank, identique au calcul embarqué."""
+        if not values:
+            return 0
+        ordered = sorted(values)
+        rank = max(1, -(-len(ordered) * pct // 100))
+        return ordered[int(rank) - 1]
+
+    def report(self) -> str:
+        lines = [
+            f"badges tracés : {self.badges} | ouvertures tracées : {self.opens}",
+            f"{'étape':<10} {'n':>6} {'p50 (us)':>10} {'p99 (us)':>10} {'max (us)':>10}",
+        ]
+        for stage in STAGES:
+            values = self.samples[stage]
+            if not values:
+                continue
+            lines.append(
+                f"{stage:<10} {len(values):>6} "
+                f"{self.percentile(values, 50):>10.0f} "
+                f"{self.percentile(values, 99):>10.0f} "
+                f"{max(values):>10.0f}"
+            )
+        return "\n".join(lines)
+
+
+# ==================================================
+# SOURCES
+# ==================================================
+def from_file(path: str, agg: TraceAggregator):
+    stream = sys.stdin if path == "-" else open(path, encoding="utf-8")
+    try:
+        for line in stream:
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                agg.feed(json.loads(line))
+            except json.JSONDecodeError:
+                pass
+    finally:
+        if stream is not sys.stdin:
+            stream.close()
+
+
+def from_port(port: str, duration: float, agg: TraceAggregator):
+    from core.serial_link import SerialLink
+
+    link = SerialLink()
+    link.on_message = agg.feed
+    link.connect(port)
+
+    if not link.wait_connected(5):
+        print("Échec connexion Arduino")
+        return
+
+    print(f"Collecte pendant {duration:.0f}s (Ctrl+C pour arrêter)...")
+    try:
+        time.sleep(duration)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.stop()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Rapport de latence badge -> relais")
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="port série d'une porte en direct")
+    src.add_argument("--file", help="fichier JSON lines (ou '-' pour stdin)")
+    parser.add_argument("--duration", type=float, default=60.0,
+                        help="durée de collecte en direct (s)")
+    args = parser.parse_args()
+
+    agg = TraceAggregator()
+    if args.port:
+        from_port(args.port, args.duration, agg)
+    else:
+        from_file(args.file, agg)
+
+    print(agg.report())
+
+
+if __name__ == "__main__":
+    main()
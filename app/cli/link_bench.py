@@ -0,0 +1,128 @@
+"""
+Benchmark CPU hôte du lien série (SerialLink).
+
+Mesure le temps CPU du processus (tous threads) pendant que le lien est
+connecté mais muet, puis optionnellement sous un flux de messages.
+Sans matériel, une paire pty joue le rôle du contrôleur (POSIX uniquement).
+
+    python -m cli.link_bench                          (pty, 10 s idle)
+    python -m cli.link_bench --duration 30 --rate 50  (idle puis 50 msg/s)
+    python -m cli.link_bench --port /dev/ttyACM0      (porte réelle, idle)
+"""
+
+import argparse
+import json
+import os
+import sys
+import threading
+import time
+
+
+# ==================================================
+# CONTRÔLEUR SIMULÉ (pty)
+# ==================================================
+class FakeDoor:
+    """Côté maître d'un pty : écrit des événements JSON au rythme demandé."""
+
+    def __init__(self):
+        import tty
+
+        self.master, slave = os.openpty()
+        tty.setraw(slave)
+        self.slave_name = os.ttyname(slave)
+        self._slave = slave
+        self._stop = threading.Event()
+        self.sent = 0
+
+    def stream(self, rate: float, duration: float):
+        msg = {"type": "door_state", "door": 0, "state": "closed"}
+        period = 1.0 / rate
+        end = time.monotonic() + duration
+        next_t = time.monotonic()
+        while time.monotonic() < end and not self._stop.is_set():
+            msg["id"] = f"bench-{self.sent}"
+            os.write(self.master, (json.dumps(msg) + "\n").encode("utf-8"))
+            self.sent += 1
+            next_t += period
+            delay = next_t - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+
+    def close(self):
+        self._stop.set()
+        for fd in (self.master, self._slave):
+            try:
+                os.close(fd)
+            except OSError:
+                pass
+
+
+# ==================================================
+# MESURE
+# ==================================================
+def measure(duration: float, work=None) -> float:
+    """% d'un cœur consommé par le processus pendant duration secondes."""
+    cpu0 = time.process_time()
+    wall0 = time.monotonic()
+    if work:
+        work()
+    else:
+        time.sleep(duration)
+    wall = time.monotonic() - wall0
+    return 100.0 * (time.process_time() - cpu0) / wall if wall > 0 else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark CPU du lien série")
+    parser.add_argument("--port", help="port série réel (défaut : pty simulé)")
+    parser.add_argument("--duration", type=float, default=10.0,
+                        help="durée de chaque mesure (s)")
+    parser.add_argument("--rate", type=float, default=0.0,
+                        help="msg/s pour la mesure en charge (pty uniquement, 0 = aucune)")
+    args = parser.parse_args()
+
+    from core.serial_link import SerialLink
+
+    door = None
+    port = args.port
+    if not port:
+        if not hasattr(os, "openpty"):
+            print("pty indisponible : utiliser --port")
+            sys.exit(1)
+        door = FakeDoor()
+        port = door.slave_name
+
+    received = []
+    link = SerialLink()
+    link.on_message = received.append
+    link.connect(port)
+
+    if not link.wait_connected(5):
+        print("Échec connexion")
+        if door:
+            door.close()
+        sys.exit(1)
+
+    try:
+        print(f"Idle {args.duration:.0f}s...")
+        idle = measure(args.duration)
+        print(f"CPU idle   : {idle:5.1f} % d'un cœur")
+
+        if door and args.rate > 0:
+            print(f"Charge {args.rate:.0f} msg/s pendant {args.duration:.0f}s...")
+            load = measure(args.duration, lambda: door.stream(args.rate, args.duration))
+            time.sleep(SerialLink.READ_TIMEOUT * 2)   # laisser le dispatcher finir
+            print(f"CPU charge : {load:5.1f} % d'un cœur")
+            print(f"envoyés {door.sent} | reçus {len(received)}")
+
+        print(f"lien : {link.stats()}")
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.stop()
+        if door:
+            door.close()
+
+
+if __name__ == "__main__":
+    main()
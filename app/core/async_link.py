@@ -0,0 +1,248 @@
+import asyncio
+import json
+import time
+from typing import Optional, Callable
+
+import serial
+
+from core.serial_link import SerialLink
+
+
+class AsyncLink:
+    """
+    Lien série vers un contrôleur, version asyncio (hub multi-portes).
+
+    - Aucun thread : le descripteur du port est surveillé par la boucle
+      (loop.add_reader, POSIX), N ports = une seule boucle.
+    - Même protocole que SerialLink : "id" repris par le firmware,
+      await send() -> réponse finale, délai max par requête, requêtes en
+      vol bornées, messages non sollicités vers les abonnés.
+    - Reconnexion automatique tant que run() tourne.
+    """
+
+    RECONNECT_DELAY = 1.0     # s
+    RESET_DELAY = 2.2         # s, reset de l'Arduino à l'ouverture du port
+
+    def __init__(self, name: str, port: str, baudrate: int = 115200,
+                 max_in_flight: int = SerialLink.MAX_IN_FLIGHT):
+        self.name = name
+        self.port = port
+        self.baudrate = baudrate
+        self.ser: Optional[serial.Serial] = None
+
+        self._buffer = bytearray()
+        self._pending: dict[str, tuple[asyncio.Future, float]] = {}
+        self._slots = asyncio.Semaphore(max_in_flight)
+        self._next_id = 0
+        self._subscribers: list[tuple[Callable[[str, dict], None], Optional[frozenset]]] = []
+
+        self._connected = asyncio.Event()
+        self._lost: Optional[asyncio.Future] = None
+        self._running = False
+
+        # Compteurs (stats hub)
+        self.lines = 0
+        self.bad_lines = 0
+        self.overflows = 0
+        self.timeouts = 0
+        self.reconnects = 0
+        self.connected_since: Optional[float] = None
+
+    # ==================================================
+    # CYCLE DE VIE
+    # ==================================================
+    @property
+    def connected(self) -> bool:
+        return self._connected.is_set()
+
+    async def wait_connected(self, timeout: float) -> bool:
+        try:
+            await asyncio.wait_for(self._connected.wait(), timeout)
+            return True
+        except asyncio.TimeoutError:
+            return False
+
+    async def run(self):
+        """Tâche de connexion : ouvre le port, attend sa perte, recommence."""
+        loop = asyncio.get_running_loop()
+        self._running = True
+
+        while self._running:
+            try:
+                self.ser = serial.Serial(self.port, self.baudrate, timeout=0, write_timeout=0.1)
+            except (serial.SerialException, OSError):
+                await asyncio.sleep(self.RECONNECT_DELAY)
+                continue
+
+            await asyncio.sleep(self.RESET_DELAY)
+            self.ser.reset_input_buffer()
+            self._buffer.clear()
+
+            self._lost = loop.create_future()
+            loop.add_reader(self.ser.fileno(), self._on_readable)
+            self._connected.set()
+            self.connected_since = time.time()
+
+            try:
+                await self._lost
+            finally:
+                self._close("Arduino déconnecté")
+
+            if self._running:
+                self.reconnects += 1
+                await asyncio.sleep(self.RECONNECT_DELAY)
+
+    def stop(self):
+        self._running = False
+        if self._lost and not self._lost.done():
+            self._lost.set_result(None)
+        else:
+            self._close("Lien arrêté")
+
+    def _close(self, reason: str):
+        self._connected.clear()
+        self.connected_since = None
+        if self.ser:
+            try:
+                asyncio.get_running_loop().remove_reader(self.ser.fileno())
+            except (RuntimeError, ValueError, OSError):
+                pass
+            try:
+                self.ser.close()
+            except Exception:
+                pass
+            self.ser = None
+
+        for fut, _ in self._pending.values():
+            if not fut.done():
+                fut.set_exception(ConnectionError(reason))
+        self._pending.clear()
+
+    # ==================================================
+    # LECTURE (callback de la boucle, jamais bloquant)
+    # ==================================================
+    def _on_readable(self):
+        try:
+            data = self.ser.read(self.ser.in_waiting or 1)
+        except (serial.SerialException, OSError, TypeError):
+            data = None
+
+        if not data:
+            # readable sans donnée : port disparu (câble USB retiré)
+            if self._lost and not self._lost.done():
+                self._lost.set_result(None)
+            return
+
+        self._buffer += data
+        while True:
+            end = self._buffer.find(b"\n")
+            if end < 0:
+                break
+            line = bytes(self._buffer[:end])
+            del self._buffer[:end + 1]
+            self._dispatch(line)
+
+        if len(self._buffer) > SerialLink.MAX_LINE:
+            self.overflows += 1
+            self._buffer.clear()
+
+    def _dispatch(self, raw: bytes):
+        line = raw.decode("utf-8", errors="ignore").strip()
+        if not line:
+            return
+        try:
+            msg = json.loads(line)
+        except json.JSONDecodeError:
+            self.bad_lines += 1
+            return
+        if not isinstance(msg, dict):
+            self.bad_lines += 1
+            return
+
+        self.lines += 1
+
+        req_id = msg.get("id")
+        if isinstance(req_id, str) and req_id in self._pending:
+            if msg.get("status") in SerialLink.INTERIM_STATUSES:
+                return
+            fut, _ = self._pending.pop(req_id)
+            if not fut.done():
+                fut.set_result(msg)
+            return
+
+        kind = msg.get("type") or msg.get("action")
+        for callback, types in list(self._subscribers):
+            if types is None or kind in types:
+                try:
+                    callback(self.name, msg)
+                except Exception:
+                    pass
+
+    # ==================================================
+    # REQUÊTES
+    # ==================================================
+    async def send(self, payload: dict, timeout: float = SerialLink.DEFAULT_TIMEOUT) -> dict:
+        """
+        Envoie une requête et attend sa réponse finale.
+        TimeoutError après timeout s (attente d'un créneau comprise),
+        ConnectionError si le port n'est pas ouvert ou tombe.
+        """
+        if not self.connected:
+            raise ConnectionError(f"{self.name} non connecté")
+
+        deadline = time.monotonic() + timeout
+        try:
+            await asyncio.wait_for(self._slots.acquire(), timeout)
+        except asyncio.TimeoutError:
+            self.timeouts += 1
+            raise TimeoutError(f"{self.name} : trop de requêtes en cours")
+
+        try:
+            request = dict(payload)
+            req_id = request.get("id")
+            if not req_id:
+                self._next_id = (self._next_id + 1) % SerialLink.MAX_ID
+                req_id = f"h{self._next_id}"
+                request["id"] = req_id
+
+            fut = asyncio.get_running_loop().create_future()
+            self._pending[req_id] = (fut, deadline)
+
+            try:
+                self.ser.write((json.dumps(request) + "\n").encode("utf-8"))
+            except (serial.SerialException, OSError, AttributeError):
+                self._pending.pop(req_id, None)
+                if self._lost and not self._lost.done():
+                    self._lost.set_result(None)
+                raise ConnectionError(f"{self.name} : erreur d'envoi série")
+
+            try:
+                return await asyncio.wait_for(fut, max(0.0, deadline - time.monotonic()))
+            except asyncio.TimeoutError:
+                self._pending.pop(req_id, None)
+                self.timeouts += 1
+                raise TimeoutError(f"{self.name} : pas de réponse")
+        finally:
+            self._slots.release()
+
+    # ==================================================
+    # ABONNEMENTS
+    # ==================================================
+    def subscribe(self, callback: Callable[[str, dict], None], *types: str):
+        """callback(nom_porte, msg) pour chaque message non sollicité."""
+        self._subscribers.append((callback, frozenset(types) if types else None))
+
+    def unsubscribe(self, callback: Callable[[str, dict], None]):
+        self._subscribers = [(cb, t) for cb, t in self._subscribers if cb != callback]
+
+    def stats(self) -> dict:
+        return {
+            "port": self.port,
+            "connected": self.connected,
+            "lines": self.lines,
+            "bad_lines": self.bad_lines,
+            "overflows": self.overflows,
+            "timeouts": self.timeouts,
+            "reconnects": self.reconnects,
+            "in_flight": len(self._pending),
+        }
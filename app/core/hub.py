@@ -0,0 +1,258 @@
+import asyncio
+import json
+import os
+from typing import Optional
+
+from core.async_link import AsyncLink
+from core.protocol import Protocol
+
+
+class Hub:
+    """
+    Hub multi-contrôleurs : N portes, une seule boucle asyncio.
+
+    - Une AsyncLink par porte (nom -> port série), reconnexion automatique.
+    - Commandes de flotte en fan-out, au plus max_parallel portes à la fois :
+      list, stats (agrégées), send, push (jeu de profils badges), collect_logs.
+    - API locale : socket Unix, une requête JSON par ligne, une réponse JSON
+      par ligne ({"op": "events"} : flux des événements non sollicités).
+    - Les commandes admin passent le PIN avant chaque commande (la session
+      admin du firmware se referme après chaque commande).
+    """
+
+    DEFAULT_PARALLEL = 8
+    PUSH_TIMEOUT = 5.0        # s par commande
+    AUDIT_TIMEOUT = 2.0       # s par bloc du journal
+    EVENT_QUEUE = 256         # événements en attente par client "events" (au-delà : perdus)
+
+    def __init__(self, doors: dict, max_parallel: int = DEFAULT_PARALLEL, log_dir: str = "audit"):
+        self.links = {name: AsyncLink(name, port) for name, port in doors.items()}
+        self.max_parallel = max_parallel
+        self.log_dir = log_dir
+
+        self._limit: Optional[asyncio.Semaphore] = None
+        self._tasks: list[asyncio.Task] = []
+        self._listeners: set[asyncio.Queue] = set()
+
+    # ==================================================
+    # CYCLE DE VIE
+    # ==================================================
+    async def start(self):
+        self._limit = asyncio.Semaphore(self.max_parallel)
+        for link in self.links.values():
+            link.subscribe(self._on_event)
+            self._tasks.append(asyncio.create_task(link.run()))
+
+    async def stop(self):
+        for link in self.links.values():
+            link.stop()
+        await asyncio.gather(*self._tasks, return_exceptions=True)
+
+    def _on_event(self, door: str, msg: dict):
+        event = {"door": door, "event": msg}
+        for q in list(self._listeners):
+            try:
+                q.put_nowait(event)
+            except asyncio.QueueFull:
+                pass
+
+    # ==================================================
+    # FAN-OUT
+    # ==================================================
+    def _targets(self, doors) -> list[AsyncLink]:
+        if not doors or doors == "all":
+            return list(self.links.values())
+        unknown = [d for d in doors if d not in self.links]
+        if unknown:
+            raise KeyError(f"porte(s) inconnue(s) : {', '.join(unknown)}")
+        return [self.links[d] for d in doors]
+
+    async def _fan_out(self, doors, work) -> dict:
+        """work(link) sur chaque porte, max_parallel à la fois : nom -> résultat ou erreur."""
+
+        async def one(link: AsyncLink):
+            async with self._limit:
+                try:
+                    return link.name, {"ok": True, "result": await work(link)}
+                except Exception as e:
+                    return link.name, {"ok": False, "error": str(e) or type(e).__name__}
+
+        return dict(await asyncio.gather(*(one(l) for l in self._targets(doors))))
+
+    @staticmethod
+    async def _admin(link: AsyncLink, pin: str, payload: dict, timeout: float) -> dict:
+        auth = await link.send(Protocol.admin_auth(pin), timeout)
+        if not auth.get("access_granted"):
+            raise PermissionError("PIN refusé" + (" (bloqué)" if auth.get("locked") else ""))
+        return await link.send(payload, timeout)
+
+    # ==================================================
+    # COMMANDES DE FLOTTE
+    # ==================================================
+    def list(self) -> dict:
+        return {name: link.stats() for name, link in self.links.items()}
+
+    async def stats(self, doors=None) -> dict:
+        per_door = await self._fan_out(doors, lambda link: link.send(Protocol.STATS))
+        return {"summary": self.summarize(per_door), "doors": per_door}
+
+    @staticmethod
+    def summarize(per_door: dict) -> dict:
+        """Totaux de flotte à partir des réponses "stats" de chaque porte."""
+        ok = [r["result"] for r in per_door.values() if r["ok"]]
+        idle = [s.get("power", {}).get("idle_pct", 0) for s in ok]
+        readers = [r for s in ok for r in s.get("rfid", [])]
+        return {
+            "doors": len(per_door),
+            "responded": len(ok),
+            "failed": len(per_door) - len(ok),
+            "idle_pct_avg": round(sum(idle) / len(idle), 1) if idle else 0,
+            "rfid_reads": sum(r.get("reads", 0) for r in readers),
+            "readers_offline": sum(1 for r in readers if not r.get("online", True)),
+            "sources_locked": sum(
+                1 for s in ok for src in s.get("lockout", {}).values() if src.get("locked_s", 0) > 0
+            ),
+            "audit_dropped": sum(s.get("audit", {}).get("dropped", 0) for s in ok),
+            "keypad_dropped": sum(s.get("keypad", {}).get("dropped", 0) for s in ok),
+        }
+
+    async def send(self, cmd: str, doors=None, pin: Optional[str] = None,
+                   timeout: float = PUSH_TIMEOUT) -> dict:
+        """Même commande sur chaque porte (précédée du PIN si donné)."""
+        payload = {"cmd": cmd}
+        if pin:
+            return await self._fan_out(doors, lambda link: self._admin(link, pin, payload, timeout))
+        return await self._fan_out(doors, lambda link: link.send(payload, timeout))
+
+    async def push(self, badge_set: dict, pin: str, doors=None) -> dict:
+        """
+        Applique un jeu de profils badges à chaque porte, commande par commande
+        (arrêt à la 1re erreur sur une porte, les autres continuent).
+        """
+        commands = badge_set_commands(badge_set)
+
+        async def apply(link: AsyncLink):
+            for payload in commands:
+                reply = await self._admin(link, pin, payload, self.PUSH_TIMEOUT)
+                if reply.get("status") != "success":
+                    raise RuntimeError(f"{payload['cmd']} : {reply.get('message', reply.get('status'))}")
+            return len(commands)
+
+        return await self._fan_out(doors, apply)
+
+    async def collect_logs(self, doors=None) -> dict:
+        """Journal d'accès de chaque porte -> <log_dir>/<porte>.jsonl, reprise au curseur."""
+        from cli.audit_download import audit_rows, load_cursor, save_cursor
+
+        os.makedirs(self.log_dir, exist_ok=True)
+
+        async def download(link: AsyncLink):
+            out_path = os.path.join(self.log_dir, f"{link.name}.jsonl")
+            cursor_path = out_path + ".cursor"
+            cursor = load_cursor(cursor_path)
+            total = 0
+            with open(out_path, "a", encoding="utf-8") as out:
+                while True:
+                    request = Protocol.AUDIT if cursor is None else Protocol.audit_from(cursor)
+                    msg = await link.send(request, self.AUDIT_TIMEOUT)
+                    if msg.get("status") != "success":
+                        raise RuntimeError(str(msg.get("message", msg.get("status"))))
+                    for row in audit_rows(msg):
+                        out.write(json.dumps(row) + "\n")
+                        total += 1
+                    out.flush()
+                    cursor = msg["next"]
+                    save_cursor(cursor_path, cursor)
+                    if not msg.get("more"):
+                        return total
+
+        return await self._fan_out(doors, download)
+
+    # ==================================================
+    # API LOCALE (socket Unix, JSON lines)
+    # ==================================================
+    async def serve(self, path: str):
+        if os.path.exists(path):
+            os.unlink(path)
+        server = await asyncio.start_unix_server(self._client, path=path)
+        os.chmod(path, 0o600)   # PIN admin en clair dans les requêtes : propriétaire uniquement
+        async with server:
+            await server.serve_forever()
+
+    async def _client(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+        try:
+            while True:
+                line = await reader.readline()
+                if not line:
+                    break
+                try:
+                    req = json.loads(line)
+                    if req.get("op") == "events":
+                        await self._stream_events(writer)
+                        break
+                    reply = {"ok": True, "result": await self._handle(req)}
+                except Exception as e:
+                    reply = {"ok": False, "error": str(e) or type(e).__name__}
+                writer.write((json.dumps(reply) + "\n").encode("utf-8"))
+                await writer.drain()
+        except (ConnectionError, asyncio.IncompleteReadError):
+            pass
+        finally:
+            writer.close()
+
+    async def _handle(self, req: dict):
+        op = req.get("op")
+        doors = req.get("doors")
+        if op == "list":
+            return self.list()
+        if op == "stats":
+            return await self.stats(doors)
+        if op == "send":
+            return await self.send(str(req["cmd"]), doors, req.get("pin"),
+                                   float(req.get("timeout", self.PUSH_TIMEOUT)))
+        if op == "push":
+            return await self.push(req["badge_set"], req["pin"], doors)
+        if op == "collect_logs":
+            return await self.collect_logs(doors)
+        raise ValueError(f"op inconnue : {op}")
+
+    async def _stream_events(self, writer: asyncio.StreamWriter):
+        q: asyncio.Queue = asyncio.Queue(self.EVENT_QUEUE)
+        self._listeners.add(q)
+        try:
+            while True:
+                event = await q.get()
+                writer.write((json.dumps(event) + "\n").encode("utf-8"))
+                await writer.drain()
+        finally:
+            self._listeners.discard(q)
+
+
+# ==================================================
+# JEU DE PROFILS BADGES -> COMMANDES
+# ==================================================
+def badge_set_commands(badge_set: dict) -> list[dict]:
+    """
+    Le firmware n'enrôle un badge qu'en le présentant au lecteur (UID jamais
+    transmis) : le jeu poussé porte sur ce qui est adressable à distance.
+
+    {
+      "templates": {"1": [[31, "0800", "1800"]]},   # modèle -> plages (jours, début, fin)
+      "badges": {"3": {"roles": 5, "schedule": 1}}, # slot -> rôles / modèle horaire
+      "config": {"1": 3000}                         # champ -> valeur (Protocol.CONFIG_*)
+    }
+    Un modèle listé est d'abord vidé puis reconstruit.
+    """
+    commands = []
+    for tpl, windows in sorted(badge_set.get("templates", {}).items()):
+        commands.append(Protocol.schedule_clear(int(tpl)))
+        for days, start, end in windows:
+            commands.append(Protocol.schedule_window(int(tpl), int(days), start, end))
+    for slot, profile in sorted(badge_set.get("badges", {}).items(), key=lambda kv: int(kv[0])):
+        if "roles" in profile:
+            commands.append(Protocol.badge_roles(int(slot), int(profile["roles"])))
+        if "schedule" in profile:
+            commands.append(Protocol.badge_schedule(int(slot), int(profile["schedule"])))
+    for field, value in sorted(badge_set.get("config", {}).items()):
+        commands.append(Protocol.config_set(int(field), int(value)))
+    return commands
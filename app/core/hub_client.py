@@ -0,0 +1,61 @@
+import json
+import socket
+from typing import Optional, Iterator
+
+
+DEFAULT_SOCKET = "/tmp/smartdoor-hub.sock"
+
+
+class HubClient:
+    """
+    Client de l'API locale du hub (socket Unix, JSON lines) pour le CLI / GUI.
+    Une connexion par appel : le hub traite les clients en parallèle.
+    """
+
+    def __init__(self, path: str = DEFAULT_SOCKET, timeout: float = 120.0):
+        self.path = path
+        self.timeout = timeout
+
+    def _connect(self) -> socket.socket:
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        sock.settimeout(self.timeout)
+        sock.connect(self.path)
+        return sock
+
+    def request(self, op: str, **fields):
+        """Résultat de l'opération ; RuntimeError si le hub signale une erreur."""
+        with self._connect() as sock:
+            sock.sendall((json.dumps({"op": op, **fields}) + "\n").encode("utf-8"))
+            line = sock.makefile("rb").readline()
+        if not line:
+            raise RuntimeError("Hub : connexion fermée")
+        reply = json.loads(line)
+        if not reply.get("ok"):
+            raise RuntimeError(reply.get("error", "erreur hub"))
+        return reply["result"]
+
+    def list(self) -> dict:
+        return self.request("list")
+
+    def stats(self, doors: Optional[list] = None) -> dict:
+        return self.request("stats", doors=doors)
+
+    def send(self, cmd: str, doors: Optional[list] = None, pin: Optional[str] = None) -> dict:
+        return self.request("send", cmd=cmd, doors=doors, pin=pin)
+
+    def push(self, badge_set: dict, pin: str, doors: Optional[list] = None) -> dict:
+        return self.request("push", badge_set=badge_set, pin=pin, doors=doors)
+
+    def collect_logs(self, doors: Optional[list] = None) -> dict:
+        return self.request("collect_logs", doors=doors)
+
+    def events(self) -> Iterator[dict]:
+        """Flux des événements non sollicités de toutes les portes (bloquant)."""
+        sock = self._connect()
+        sock.settimeout(None)
+        try:
+            sock.sendall(b'{"op": "events"}\n')
+            for line in sock.makefile("rb"):
+                yield json.loads(line)
+        finally:
+            sock.close()
@@ -4,6 +4,10 @@ class Protocol:
     """
     Définition STRICTE des commandes série acceptées par l'Arduino.
     Ce module ne contient AUCUNE logique métier.
+
+    Chaque requête reçoit un "id" (ajouté par SerialLink.send, 15 caractères
+    max) que l'Arduino reprend dans toutes ses réponses, y compris la réponse
+    différée d'ADD_BADGE / REMOVE_BADGE (après le statut "scan_required").
     """
 
     # ==================================================
@@ -14,6 +18,91 @@ class Protocol:
     REMOVE_BADGE = {"cmd": "12"}
     LIST_BADGES = {"cmd": "13"}
     RESET_REQUEST = {"cmd": "14"}
+    RFID_BENCH = {"cmd": "rfid_bench"}   # mesure polling vs IRQ (~1 s bloquant)
+    RFID_SELFTEST = {"cmd": "rfid_selftest"}   # coût / taux de lecture par profil (carte posée)
+
+    @staticmethod
+    def open_door(door: int) -> dict:
+        """
+        Ouverture d'une porte précise de la banque de relais (OPEN_DOOR = porte 0).
+        Exemple : {"cmd": "101"}
+        """
+        return {"cmd": f"10{door}"}
+
+    @staticmethod
+    def close_door(door: int) -> dict:
+        """
+        Fermeture forcée (relais en mode maintenu, ou ouverture en attente).
+        """
+        return {"cmd": f"15{door}"}
+
+    @staticmethod
+    def reader_profile(index: int) -> dict:
+        """
+        Profil lecteur RFID persistant : 0 rapide, 1 équilibré, 2 portée.
+        Exemple : {"cmd": "202"}
+        """
+        return {"cmd": f"20{index}"}
+
+    # Champs de configuration runtime (commande 40<champ><valeur>)
+    CONFIG_OPEN_MS = 1        # durée d'ouverture relais, 100..60000 ms
+    CONFIG_MAX_ATTEMPTS = 2   # essais PIN avant blocage, 1..20
+    CONFIG_LOCKOUT_S = 3      # 1er blocage (s), doublé à chaque récidive, 1..3600
+    CONFIG_READER_PROFILE = 4
+
+    @staticmethod
+    def config_set(field: int, value: int) -> dict:
+        """
+        Modifie un champ de la configuration persistante (sans reflasher).
+        Exemple ouverture 3 s : {"cmd": "4013000"}
+        """
+        return {"cmd": f"40{field}{value}"}
+
+    @staticmethod
+    def clock_sync(local_epoch: int) -> dict:
+        """
+        Synchro horloge du contrôleur (heure LOCALE, secondes depuis 1970).
+        Exemple : {"cmd": "301760000000"}
+        """
+        return {"cmd": f"30{local_epoch:010d}"}
+
+    @staticmethod
+    def badge_schedule(slot: int, template: int) -> dict:
+        """
+        Associe un modèle horaire (0 = 24/7) au badge d'index slot.
+        Exemple : {"cmd": "31032"}
+        """
+        return {"cmd": f"31{slot:02d}{template}"}
+
+    @staticmethod
+    def schedule_window(template: int, days_mask: int, start: str, end: str) -> dict:
+        """
+        Ajoute une plage au modèle : jours bit 0 = lundi ... bit 6 = dimanche,
+        start/end "HHMM" (fin exclue, "2400" = minuit).
+        Exemple lun-ven 08h-18h : {"cmd": "32103108001800"}
+        """
+        return {"cmd": f"32{template}{days_mask:03d}{start}{end}"}
+
+    @staticmethod
+    def schedule_clear(template: int) -> dict:
+        """
+        Vide un modèle horaire (plus aucun créneau autorisé).
+        """
+        return {"cmd": f"33{template}"}
+
+    # Rôles badge (bits combinables)
+    ROLE_USER = 0x01          # porte, selon son modèle horaire
+    ROLE_SUPERVISOR = 0x02    # porte, sans restriction horaire
+    ROLE_ADMIN = 0x04         # badge admin : remplace le PIN
+    ROLE_MAINTENANCE = 0x08   # porte même si l'horloge n'est pas synchronisée
+
+    @staticmethod
+    def badge_roles(slot: int, roles: int) -> dict:
+        """
+        Rôles du badge d'index slot (ordre de LIST_BADGES).
+        Exemple utilisateur + admin : {"cmd": "340305"}
+        """
+        return {"cmd": f"34{slot:02d}{roles:02d}"}
 
     # ==================================================
     # SOUS-COMMANDES (utilisées UNIQUEMENT après RESET_REQUEST)
@@ -21,6 +110,22 @@ class Protocol:
     # ==================================================
     CONFIRM_RESET = {"cmd": "99"}
     CANCEL_RESET = {"cmd": "00"}
+
+    # ==================================================
+    # DIAGNOSTIC (lecture seule, SANS PIN)
+    # ==================================================
+    STATS = {"cmd": "stats"}
+    CONFIG = {"cmd": "config"}   # configuration runtime + version du layout EEPROM
+    AUDIT = {"cmd": "audit"}   # journal d'accès, depuis le plus ancien enregistrement
+    MEM = {"cmd": "mem"}   # RAM libre, pics pile / tas + étape de loop(), plus grand bloc libre
+
+    @staticmethod
+    def audit_from(seq: int) -> dict:
+        """
+        Bloc suivant du journal d'accès à partir du curseur "next" reçu.
+        Exemple : {"cmd": "audit1234"}
+        """
+        return {"cmd": f"audit{seq & 0xFFFF}"}
    
     # ==================================================
     # AUTHENTIFICATION ADMIN
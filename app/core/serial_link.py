@@ -1,28 +1,76 @@
 import serial
 import serial.tools.list_ports
 import threading
+import queue
 import json
 import time
+from concurrent.futures import Future
 from typing import Optional, Callable
 
 
 class SerialLink:
-    def __init__(self, baudrate: int = 115200):
+    """
+    Lien série vers un contrôleur de porte.
+
+    - Thread lecteur : read() bloquant avec timeout (aucune boucle active
+      quand la ligne est muette), découpage en lignes dans un tampon interne.
+    - Thread dispatcher : décode le JSON et appelle on_message / on_status,
+      un callback lent ne retarde jamais la lecture du port.
+    - Requêtes : send() renvoie un Future résolu par la réponse portant le
+      même "id" (le firmware le reprend), avec délai max par requête et
+      nombre borné de requêtes en vol. Les messages non sollicités (porte,
+      badge, boot...) vont aux abonnés de subscribe().
+    """
+
+    READ_TIMEOUT = 0.2        # s, délai max d'un read() sans donnée (réactivité de stop())
+    READ_CHUNK = 256          # octets max par read() quand des données attendent déjà
+    MAX_LINE = 4096           # au-delà sans '\n' : bruit, tampon vidé
+
+    DEFAULT_TIMEOUT = 5.0     # s, délai max de réponse d'une requête
+    MAX_IN_FLIGHT = 2         # requêtes sans réponse (tampon RX de l'Arduino : 64 octets)
+    MAX_ID = 1_000_000        # ids "h<n>" : au plus 7 caractères (REQ_ID_MAX_LEN = 15)
+    SWEEP_INTERVAL = 0.1      # s, contrôle des délais tant qu'une requête est en vol
+
+    # Statuts intermédiaires : la réponse finale suit (ex. badge à présenter)
+    INTERIM_STATUSES = ("scan_required",)
+
+    def __init__(self, baudrate: int = 115200, max_in_flight: int = MAX_IN_FLIGHT):
         self.port: Optional[str] = None
         self.baudrate = baudrate
         self.ser: Optional[serial.Serial] = None
 
         self.running = False
         self.thread: Optional[threading.Thread] = None
+        self._dispatch_thread: Optional[threading.Thread] = None
+        self._events: "queue.Queue" = queue.Queue()
+
+        # Tampon de réception (lignes incomplètes)
+        self._buffer = bytearray()
 
-        # Callbacks
+        # Callbacks (appelés depuis le thread dispatcher)
+        # on_message : TOUS les messages (journal), réponses comprises
         self.on_message: Optional[Callable[[dict], None]] = None
         self.on_status: Optional[Callable[[bool], None]] = None
 
+        # Requêtes en vol : id -> (Future, échéance monotonic)
+        self._pending: dict[str, tuple[Future, float]] = {}
+        self._pending_lock = threading.Lock()
+        self._slots = threading.BoundedSemaphore(max_in_flight)
+        self._next_id = 0
+
+        # Abonnés aux messages non sollicités : (callback, types ou None = tous)
+        self._subscribers: list[tuple[Callable[[dict], None], Optional[frozenset]]] = []
+
         # Synchronisation connexion réelle
         self._connected_event = threading.Event()
         self._lock = threading.Lock()
 
+        # Compteurs (diagnostic / benchmark)
+        self.lines = 0
+        self.bad_lines = 0
+        self.overflows = 0
+        self.timeouts = 0
+
     # ==================================================
     # LISTE DES PORTS (CLI / GUI)
     # ==================================================
@@ -39,6 +87,11 @@ class SerialLink:
 
         self.port = port
         self.running = True
+        self._dispatch_thread = threading.Thread(
+            target=self._dispatcher,
+            daemon=True
+        )
+        self._dispatch_thread.start()
         self.thread = threading.Thread(
             target=self._worker,
             daemon=True
@@ -53,7 +106,7 @@ class SerialLink:
         return self._connected_event.wait(timeout)
 
     # ==================================================
-    # THREAD PRINCIPAL
+    # THREAD LECTEUR
     # ==================================================
     def _worker(self):
         while self.running:
@@ -64,68 +117,233 @@ class SerialLink:
                     self.ser = serial.Serial(
                         self.port,
                         self.baudrate,
-                        timeout=0.05,
+                        timeout=self.READ_TIMEOUT,
                         write_timeout=0.1
                     )
 
                     # Reset Arduino
                     time.sleep(2.2)
 
+                    self._buffer.clear()
                     self._connected_event.set()
-                    if self.on_status:
-                        self.on_status(True)
+                    self._events.put(("status", True))
 
                 except serial.SerialException:
                     self.ser = None
                     self._connected_event.clear()
-                    if self.on_status:
-                        self.on_status(False)
+                    self._events.put(("status", False))
                     time.sleep(1)
                     continue
 
             # ---------- Lecture ----------
             try:
-                while self.ser and self.ser.in_waiting:
-                    line = self.ser.readline().decode(
-                        "utf-8", errors="ignore"
-                    ).strip()
-
-                    if not line:
-                        continue
-
-                    try:
-                        obj = json.loads(line)
-                        if self.on_message:
-                            self.on_message(obj)
-                    except json.JSONDecodeError:
-                        # Ignore bruit série
-                        pass
-
-            except serial.SerialException:
-                self._handle_disconnect()
+                # Bloque jusqu'au 1er octet (ou timeout), puis prend ce qui attend déjà
+                data = self.ser.read(max(1, min(self.ser.in_waiting, self.READ_CHUNK)))
+            except (serial.SerialException, OSError, TypeError, AttributeError):
+                # TypeError / AttributeError : port fermé par stop() pendant le read()
+                if self.running:
+                    self._handle_disconnect()
+                continue
+
+            if data:
+                self._feed(data)
+
+    def _feed(self, data: bytes):
+        """Ajoute les octets reçus et pousse chaque ligne complète au dispatcher."""
+        self._buffer += data
+
+        while True:
+            end = self._buffer.find(b"\n")
+            if end < 0:
+                break
+            line = bytes(self._buffer[:end])
+            del self._buffer[:end + 1]
+            self._events.put(("line", line))
+
+        if len(self._buffer) > self.MAX_LINE:
+            self.overflows += 1
+            self._buffer.clear()
+
+    # ==================================================
+    # THREAD DISPATCHER (callbacks hors thread lecteur)
+    # ==================================================
+    def _dispatcher(self):
+        while True:
+            wait = self.SWEEP_INTERVAL if self._pending else None
+            try:
+                kind, value = self._events.get(timeout=wait)
+            except queue.Empty:
+                kind, value = "wake", None
+
+            self._expire_pending()
+
+            if kind == "stop":
+                return
+            if kind == "wake":
+                continue
+
+            try:
+                if kind == "status":
+                    if self.on_status:
+                        self.on_status(value)
+                    continue
+
+                line = value.decode("utf-8", errors="ignore").strip()
+                if not line:
+                    continue
+
+                try:
+                    obj = json.loads(line)
+                except json.JSONDecodeError:
+                    # Ignore bruit série
+                    self.bad_lines += 1
+                    continue
+
+                if not isinstance(obj, dict):
+                    self.bad_lines += 1
+                    continue
+
+                self.lines += 1
+                if self.on_message:
+                    self.on_message(obj)
+
+                if not self._resolve(obj):
+                    self._notify(obj)
+
+            except Exception:
+                # Un callback défaillant ne doit pas arrêter la distribution
+                pass
+
+    def _resolve(self, msg: dict) -> bool:
+        """Réponse finale à une requête en vol : résout son Future."""
+        req_id = msg.get("id")
+        if not isinstance(req_id, str) or msg.get("status") in self.INTERIM_STATUSES:
+            return req_id in self._pending if isinstance(req_id, str) else False
+
+        with self._pending_lock:
+            entry = self._pending.pop(req_id, None)
+        if not entry:
+            return False
+
+        self._slots.release()
+        entry[0].set_result(msg)
+        return True
+
+    def _notify(self, msg: dict):
+        kind = msg.get("type") or msg.get("action")
+        for callback, types in list(self._subscribers):
+            if types is None or kind in types:
+                try:
+                    callback(msg)
+                except Exception:
+                    pass
+
+    def _expire_pending(self):
+        if not self._pending:
+            return
+        now = time.monotonic()
+        with self._pending_lock:
+            expired = [k for k, (_, deadline) in self._pending.items() if deadline <= now]
+            entries = [self._pending.pop(k) for k in expired]
+        for fut, _ in entries:
+            self.timeouts += 1
+            self._slots.release()
+            fut.set_exception(TimeoutError("Pas de réponse de l'Arduino"))
+
+    def _fail_pending(self, reason: str):
+        with self._pending_lock:
+            entries = list(self._pending.values())
+            self._pending.clear()
+        for fut, _ in entries:
+            self._slots.release()
+            fut.set_exception(ConnectionError(reason))
+
+    # ==================================================
+    # ABONNEMENTS (messages non sollicités)
+    # ==================================================
+    def subscribe(self, callback: Callable[[dict], None], *types: str):
+        """
+        callback(msg) pour chaque message qui n'est pas une réponse à une
+        requête en vol, filtré sur "type" (ou "action") si types est donné.
+        Exemple : link.subscribe(on_door, "door_state")
+        """
+        self._subscribers.append((callback, frozenset(types) if types else None))
+
+    def unsubscribe(self, callback: Callable[[dict], None]):
+        self._subscribers = [(cb, t) for cb, t in self._subscribers if cb != callback]
 
     # ==================================================
     # ENVOI (THREAD-SAFE)
     # ==================================================
-    def send(self, payload: dict):
+    def send(self, payload: dict, timeout: float = DEFAULT_TIMEOUT) -> Future:
+        """
+        Envoie une requête et renvoie un Future résolu par sa réponse (dict).
+        Un "id" est ajouté s'il manque (le payload n'est pas modifié).
+        Future en erreur : TimeoutError après timeout s, ConnectionError si
+        le lien tombe. Bloque au plus timeout s si MAX_IN_FLIGHT est atteint
+        (sans attendre depuis un callback : erreur immédiate).
+        """
         if not self._connected_event.is_set():
             raise RuntimeError("Arduino non connecté")
 
-        data = json.dumps(payload) + "\n"
+        request = dict(payload)
+        req_id = request.get("id")
+        if not req_id:
+            req_id = self._new_id()
+            request["id"] = req_id
+
+        # Depuis un callback, attendre un créneau bloquerait la résolution des réponses
+        if threading.current_thread() is self._dispatch_thread:
+            got = self._slots.acquire(blocking=False)
+        else:
+            got = self._slots.acquire(timeout=timeout)
+        if not got:
+            raise RuntimeError("Trop de requêtes en cours")
+
+        fut: Future = Future()
+        with self._pending_lock:
+            self._pending[req_id] = (fut, time.monotonic() + timeout)
+        self._events.put(("wake", None))   # le dispatcher surveille l'échéance
+
+        data = json.dumps(request) + "\n"
 
         with self._lock:
             try:
                 self.ser.write(data.encode("utf-8"))
                 self.ser.flush()
-            except serial.SerialException:
+            except (serial.SerialException, AttributeError):
+                with self._pending_lock:
+                    if self._pending.pop(req_id, None):
+                        self._slots.release()
                 self._handle_disconnect()
                 raise RuntimeError("Erreur d'envoi série")
 
+        return fut
+
+    def _new_id(self) -> str:
+        with self._pending_lock:
+            self._next_id = (self._next_id + 1) % self.MAX_ID
+            return f"h{self._next_id}"
+
+    # ==================================================
+    # DIAGNOSTIC
+    # ==================================================
+    def stats(self) -> dict:
+        return {
+            "lines": self.lines,
+            "bad_lines": self.bad_lines,
+            "overflows": self.overflows,
+            "timeouts": self.timeouts,
+            "in_flight": len(self._pending),
+            "pending": self._events.qsize(),
+        }
+
     # ==================================================
     # GESTION DECONNEXION
     # ==================================================
     def _handle_disconnect(self):
         self._connected_event.clear()
+        self._fail_pending("Arduino déconnecté")
 
         if self.ser:
             try:
@@ -134,8 +352,7 @@ class SerialLink:
                 pass
             self.ser = None
 
-        if self.on_status:
-            self.on_status(False)
+        self._events.put(("status", False))
 
         time.sleep(1)
 
@@ -146,6 +363,10 @@ class SerialLink:
         self.running = False
         self._connected_event.clear()
 
+        # Le lecteur sort au plus tard après READ_TIMEOUT
+        if self.thread and self.thread is not threading.current_thread():
+            self.thread.join(self.READ_TIMEOUT + 2.5)
+
         if self.ser:
             try:
                 self.ser.close()
@@ -153,5 +374,8 @@ class SerialLink:
                 pass
             self.ser = None
 
-        if self.on_status:
-            self.on_status(False)
+        self._fail_pending("Lien arrêté")
+        self._events.put(("status", False))
+        self._events.put(("stop", None))
+        if self._dispatch_thread and self._dispatch_thread is not threading.current_thread():
+            self._dispatch_thread.join(1.0)
@@ -30,7 +30,6 @@ class DoorApp(ctk.CTk):
         self.link.on_message = self.on_message
         self.link.on_status = self.on_status
 
-        self.pending_payload = None
         self.badge_window = None
         self._command_in_progress = False
 
@@ -106,6 +105,9 @@ class DoorApp(ctk.CTk):
         self.link.connect(port)
 
     def on_status(self, connected: bool):
+        self.after(0, self._apply_status, connected)
+
+    def _apply_status(self, connected: bool):
         AppState.connected = connected
         self.status_bar.set_connected(connected)
 
@@ -115,21 +117,23 @@ class DoorApp(ctk.CTk):
             self.log.log("[INFO] Arduino déconnecté")
             AppState.reset_admin()
             self._command_in_progress = False
+            self.cancel_badge_wait()
 
     # ==================================================
     # Commandes sécurisées (ADMIN)
+    # Chaque requête renvoie un Future (SerialLink.send) : la réponse
+    # est traitée par son callback, pas devinée dans on_message.
     # ==================================================
+    REPLY_TIMEOUT = 5.0       # s
+    BADGE_TIMEOUT = 60.0      # s, le temps de présenter le badge
+
     def secure_cmd(self, payload: dict):
         if not self._begin_command():
             return
-        self.pending_payload = payload
-        self._ensure_admin_then_send()
+        self._ensure_admin_then_send(payload)
 
     def open_door(self):
-        if not self._begin_command():
-            return
-        self.pending_payload = Protocol.OPEN_DOOR
-        self._ensure_admin_then_send()
+        self.secure_cmd(Protocol.OPEN_DOOR)
 
     def reset_eeprom(self):
         if not self._begin_command():
@@ -142,8 +146,7 @@ class DoorApp(ctk.CTk):
             self._command_in_progress = False
             return
 
-        self.pending_payload = Protocol.RESET_REQUEST
-        self._ensure_admin_then_send()
+        self._ensure_admin_then_send(Protocol.RESET_REQUEST)
 
     def change_pin(self):
         if not self._begin_command():
@@ -159,8 +162,7 @@ class DoorApp(ctk.CTk):
             self._command_in_progress = False
             return
 
-        self.pending_payload = Protocol.change_pin(new_pin)
-        self._ensure_admin_then_send()
+        self._ensure_admin_then_send(Protocol.change_pin(new_pin))
 
     def _begin_command(self) -> bool:
         if not AppState.connected:
@@ -172,21 +174,81 @@ class DoorApp(ctk.CTk):
         self._command_in_progress = True
         return True
 
-    def _ensure_admin_then_send(self):
+    def _ensure_admin_then_send(self, payload: dict):
         if not AppState.admin_authenticated:
             dlg = AdminDialog()
             pin = dlg.get_input()
             if not pin:
                 self._command_in_progress = False
                 return
-            self.link.send(Protocol.admin_auth(pin))
+            self._request(Protocol.admin_auth(pin), self.REPLY_TIMEOUT,
+                          lambda reply: self._on_auth_reply(reply, payload))
         else:
-            self.link.send(self.pending_payload)
-            self._post_command_ui()
+            self._send_command(payload)
 
-    def _post_command_ui(self):
-        if self.pending_payload in (Protocol.ADD_BADGE, Protocol.REMOVE_BADGE):
+    def _send_command(self, payload: dict):
+        badge = payload in (Protocol.ADD_BADGE, Protocol.REMOVE_BADGE)
+        if badge:
             self.show_badge_wait()
+        self._request(payload, self.BADGE_TIMEOUT if badge else self.REPLY_TIMEOUT,
+                      self._on_command_reply)
+
+    def _request(self, payload: dict, timeout: float, on_reply):
+        """Envoie payload ; on_reply(dict | None) appelé dans le thread Tk."""
+        try:
+            fut = self.link.send(payload, timeout=timeout)
+        except RuntimeError as e:
+            self.log.log(f"[ERREUR] {e}")
+            self._finish_command()
+            return
+        fut.add_done_callback(lambda f: self.after(0, self._deliver, f, on_reply))
+
+    def _deliver(self, fut, on_reply):
+        try:
+            reply = fut.result()
+        except (TimeoutError, ConnectionError) as e:
+            self.log.log(f"[ERREUR] {e}")
+            self._finish_command()
+            return
+        on_reply(reply)
+
+    def _on_auth_reply(self, msg: dict, payload: dict):
+        if msg.get("access_granted"):
+            AppState.set_admin()
+            self._send_command(payload)
+            return
+
+        self._finish_command()
+        if msg.get("locked"):
+            messagebox.showerror(
+                "Admin",
+                f"Trop d'essais, réessayer dans {msg.get('retry_in_s', '?')} s"
+            )
+        else:
+            messagebox.showerror(
+                "Admin",
+                f"PIN incorrect ({msg.get('attempts_left', '?')} essai(s) restant(s))"
+            )
+
+    def _on_command_reply(self, msg: dict):
+        # Reset : confirmation déjà donnée dans la boîte de dialogue
+        if msg.get("status") == "confirm_reset":
+            self._request(Protocol.CONFIRM_RESET, self.REPLY_TIMEOUT, self._on_command_reply)
+            return
+
+        # Session admin côté Arduino refermée après chaque commande
+        AppState.reset_admin()
+        self._finish_command()
+
+        if msg.get("status") == "error":
+            messagebox.showerror(
+                "Erreur Arduino",
+                msg.get("message", "Erreur inconnue")
+            )
+
+    def _finish_command(self):
+        self._command_in_progress = False
+        self.cancel_badge_wait()
 
     # ==================================================
     # Badge wait
@@ -201,41 +263,18 @@ class DoorApp(ctk.CTk):
             self.badge_window = None
 
     # ==================================================
-    # Réponses Arduino
+    # Messages Arduino (journal + événements non sollicités)
     # ==================================================
     def on_message(self, msg: dict):
-        self.log.log(str(msg))
+        self.after(0, self._show_message, msg)
 
-        t = msg.get("type")
-        status = msg.get("status")
+    def _show_message(self, msg: dict):
+        self.log.log(str(msg))
 
         # --- Etat porte ---
-        if t == "door_state":
+        if msg.get("type") == "door_state":
             self.dashboard.set_state(msg.get("state"))
 
-        # --- Auth admin ---
-        elif t == "admin_auth":
-            if msg.get("access_granted"):
-                AppState.set_admin()
-                self.link.send(self.pending_payload)
-                self._post_command_ui()
-            else:
-                messagebox.showerror("Admin", "PIN incorrect")
-
-        # --- Fin badge / reset ---
-        elif t in ("add_badge", "remove_badge", "reset"):
-            self.cancel_badge_wait()
-
-        # --- FIN DE COMMANDE (GARANTIE) ---
-        if t != "admin_auth":
-            self._command_in_progress = False
-
-        if status == "error":
-            messagebox.showerror(
-                "Erreur Arduino",
-                msg.get("message", "Erreur inconnue")
-            )
-
     # ==================================================
     # Fermeture propre
     # ==================================================
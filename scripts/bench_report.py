@@ -0,0 +1,177 @@
+"""
+bench_report.py — débit JsonComm (src/bench/JsonCommBench.cpp) vs référence.
+
+Lit les lignes émises par le banc :
+  bench_env <env>
+  bench <cas> msgs_s=<n> bytes_s=<n> ns_msg=<n> stack=<octets> [cycles_msg=<n>]
+et compare chaque cas à bench_baseline.json (section de l'env) :
+  - msgs_s : pas plus de --tolerance % sous la référence
+  - stack  : pas plus de --stack-margin octets au-dessus de la référence
+Un cas absent de la référence est affiché sans contrôle ; un cas de la
+référence absent du banc est une erreur (cas supprimé ou banc interrompu).
+Pas encore de référence pour l'env : mesures affichées sans contrôle,
+avec un avertissement (à enregistrer : --write-baseline).
+
+Usage :
+  pio run -e native_bench -t bench          (PlatformIO : build + exécution)
+  pio run -e native_bench -t bench_baseline (idem, mesures enregistrées)
+  python scripts/bench_report.py [--bench .pio/build/native_bench/program]
+  python scripts/bench_report.py --input bench.log    (sortie Serial de mega_bench)
+                                 [--baseline bench_baseline.json]
+                                 [--tolerance 15] [--stack-margin 32]
+                                 [--write-baseline]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+DEFAULT_BENCH = os.path.join(".pio", "build", "native_bench", "program")
+ENV_PREFIX = "bench_env "
+CASE_PREFIX = "bench "
+
+
+# ==================================================
+# LECTURE
+# ==================================================
+def parse(lines) -> tuple[str, dict]:
+    """(env, {cas: {"msgs_s", "bytes_s", "ns_msg", "stack", ...}})."""
+    env, cases = None, {}
+    for line in lines:
+        line = line.strip()
+        if line.startswith(ENV_PREFIX):
+            env = line[len(ENV_PREFIX):].strip()
+        elif line.startswith(CASE_PREFIX):
+            name, *fields = line[len(CASE_PREFIX):].split()
+            cases[name] = {k: int(v) for k, v in (f.split("=", 1) for f in fields)}
+    return env, cases
+
+
+def run_bench(bench: str) -> list:
+    proc = subprocess.run([bench], stdin=subprocess.DEVNULL, capture_output=True,
+                          text=True, check=False)
+    if proc.returncode != 0:
+        raise RuntimeError(f"banc en erreur ({proc.returncode}) : {proc.stderr.strip()}")
+    return proc.stdout.splitlines()
+
+
+# ==================================================
+# COMPARAISON
+# ==================================================
+def check(cases: dict, reference: dict, tolerance: float, stack_margin: int) -> list:
+    errors = []
+    for name, ref in reference.items():
+        cur = cases.get(name)
+        if cur is None:
+            errors.append(f"cas {name} absent du banc")
+            continue
+        floor = ref["msgs_s"] * (100 - tolerance) / 100
+        if cur["msgs_s"] < floor:
+            errors.append(f"{name} : {cur['msgs_s']} msg/s < {floor:.0f} "
+                          f"(référence {ref['msgs_s']})")
+        if cur["stack"] > ref["stack"] + stack_margin:
+            errors.append(f"{name} : pile {cur['stack']} o > {ref['stack'] + stack_margin} o "
+                          f"(référence {ref['stack']})")
+    return errors
+
+
+def render(cases: dict, reference: dict) -> str:
+    rows = [f"{'cas':<18} {'msg/s':>10} {'o/s':>11} {'ns/msg':>8} {'pile':>5} {'réf msg/s':>10} {'écart':>7}"]
+    for name, c in cases.items():
+        ref = reference.get(name, {}).get("msgs_s")
+        delta = f"{(c['msgs_s'] - ref) / ref * 100:+.0f}%" if ref else "-"
+        rows.append(f"{name:<18} {c['msgs_s']:>10} {c['bytes_s']:>11} {c['ns_msg']:>8} "
+                    f"{c['stack']:>5} {ref if ref is not None else '-':>10} {delta:>7}")
+    return "\n".join(rows)
+
+
+def run(lines, baseline_path: str, tolerance: float, stack_margin: int,
+        regenerate: bool = False) -> int:
+    env, cases = parse(lines)
+    if env is None or not cases:
+        print("[bench_report] aucune ligne de banc (bench_env / bench ...) dans la sortie")
+        return 1
+
+    baseline = {}
+    if os.path.isfile(baseline_path):
+        with open(baseline_path, encoding="utf-8") as f:
+            baseline = json.load(f)
+
+    if regenerate:
+        baseline.setdefault("envs", {})[env] = cases
+        with open(baseline_path, "w", encoding="utf-8") as f:
+            json.dump(baseline, f, indent=2)
+            f.write("\n")
+        print(f"[bench_report] référence {env} écrite : {baseline_path} ({len(cases)} cas)")
+
+    reference = baseline.get("envs", {}).get(env, {})
+    print(f"env : {env}")
+    print(render(cases, reference))
+    if not reference:
+        print(f"[bench_report] AVERTISSEMENT : pas de référence pour {env} dans {baseline_path}, "
+              f"aucun contrôle (à enregistrer : --write-baseline / pio run -t bench_baseline)")
+        return 0
+
+    errors = check(cases, reference, tolerance, stack_margin)
+    for e in errors:
+        print(f"[bench_report] RÉGRESSION : {e}")
+    return 1 if errors else 0
+
+
+# ==================================================
+# INTÉGRATION PLATFORMIO (extra_scripts = post:scripts/bench_report.py)
+# ==================================================
+try:
+    Import("env")  # noqa: F821  (fourni par SCons)
+except NameError:
+    env = None
+
+if env is not None:
+    def _bench_action(regenerate: bool):
+        def _bench(*_args, **_kwargs):
+            baseline_file = os.path.join(env.subst("$PROJECT_DIR"), "bench_baseline.json")
+            lines = run_bench(env.subst("$BUILD_DIR/${PROGNAME}"))
+            if run(lines, baseline_file, 15.0, 32, regenerate) != 0:
+                env.Exit(1)
+        return _bench
+
+    env.AddCustomTarget(
+        name="bench",
+        dependencies="$BUILD_DIR/${PROGNAME}",
+        actions=[_bench_action(False)],
+        title="JsonComm bench",
+        description="Débit réception/émission JsonComm et contrôle de bench_baseline.json",
+    )
+    env.AddCustomTarget(
+        name="bench_baseline",
+        dependencies="$BUILD_DIR/${PROGNAME}",
+        actions=[_bench_action(True)],
+        title="JsonComm bench baseline",
+        description="Enregistre les mesures du banc dans bench_baseline.json",
+    )
+
+elif __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Banc JsonComm + référence")
+    parser.add_argument("--bench", default=DEFAULT_BENCH, help="binaire du banc natif")
+    parser.add_argument("--input", help="sortie déjà capturée (ex. Serial de mega_bench)")
+    parser.add_argument("--baseline", default="bench_baseline.json")
+    parser.add_argument("--tolerance", type=float, default=15.0,
+                        help="baisse de débit admise par cas (%%)")
+    parser.add_argument("--stack-margin", type=int, default=32,
+                        help="hausse de pile admise par cas (octets)")
+    parser.add_argument("--write-baseline", action="store_true",
+                        help="enregistrer ces mesures comme référence de l'env")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, encoding="utf-8", errors="replace") as f:
+            bench_lines = f.read().splitlines()
+    elif os.path.isfile(args.bench):
+        bench_lines = run_bench(args.bench)
+    else:
+        print(f"[bench_report] banc introuvable : {args.bench} (pio run -e native_bench)")
+        sys.exit(1)
+    sys.exit(run(bench_lines, args.baseline, args.tolerance, args.stack_margin,
+                 args.write_baseline))
@@ -0,0 +1,201 @@
+"""
+fuzz_report.py — fuzzing du lien série (src/fuzz/SerialFuzz.cpp) + débit.
+
+Deux modes, selon le binaire :
+  - libfuzzer : clang -fsanitize=fuzzer,address,undefined (env native_fuzz).
+    Campagne de --seconds s sur fuzz/corpus/serial (graines, non modifiées) ;
+    les entrées nouvelles vont dans le corpus de travail, les crashs dans
+    <travail>/artifacts. Débit : stat::average_exec_per_sec.
+  - replay : gcc -DFUZZ_STANDALONE + ASan/UBSan (env native_fuzz_replay).
+    Rejoue les graines (et --work s'il existe) ; débit : ligne "fuzz ... execs_s=".
+Le débit (execs/s) est comparé à fuzz_baseline.json, par env : une
+accélération du parseur se vérifie ainsi à grande échelle sans crash ni
+rapport de sanitizer. Pas encore de référence pour l'env : crashs
+contrôlés, débit affiché avec un avertissement (à enregistrer :
+--write-baseline).
+
+Usage :
+  pio run -e native_fuzz -t fuzz              (PlatformIO : build + campagne)
+  pio run -e native_fuzz_replay -t fuzz       (rejeu du corpus, gcc)
+  pio run -e <env> -t fuzz_baseline           (idem, débit enregistré)
+  python scripts/fuzz_report.py <binaire> --mode libfuzzer|replay
+                                [--env native_fuzz] [--seconds 60]
+                                [--corpus fuzz/corpus/serial] [--work .pio/fuzz]
+                                [--baseline fuzz_baseline.json] [--tolerance 20]
+                                [--write-baseline]
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+DEFAULT_CORPUS = os.path.join("fuzz", "corpus", "serial")
+MAX_LEN = 1024   # octets par entrée : ~4 lignes pleines (MAX_LINE = 256)
+
+RE_STAT = re.compile(r"^stat::(\w+):\s+(\d+)", re.M)
+RE_REPLAY = re.compile(r"^fuzz execs=(\d+) bytes=(\d+) execs_s=(\d+)", re.M)
+RE_ARTIFACT = re.compile(r"Test unit written to (\S+)")
+
+
+# ==================================================
+# EXÉCUTION
+# ==================================================
+def run_libfuzzer(binary: str, corpus: str, work: str, seconds: int) -> dict:
+    """Campagne libFuzzer : {"execs", "execs_s", "crash"}."""
+    work_corpus = os.path.join(work, "corpus")
+    artifacts = os.path.join(work, "artifacts") + os.sep
+    os.makedirs(work_corpus, exist_ok=True)
+    os.makedirs(artifacts, exist_ok=True)
+
+    proc = subprocess.run(
+        [binary, work_corpus, corpus,
+         f"-max_total_time={seconds}", f"-max_len={MAX_LEN}",
+         "-print_final_stats=1", "-close_fd_mask=1", f"-artifact_prefix={artifacts}"],
+        stdin=subprocess.DEVNULL, capture_output=True, text=True,
+        encoding="utf-8", errors="replace", check=False,
+    )
+    stats = {k: int(v) for k, v in RE_STAT.findall(proc.stderr)}
+    crash = RE_ARTIFACT.search(proc.stderr)
+    if proc.returncode != 0 and not crash:
+        raise RuntimeError(f"libFuzzer en erreur ({proc.returncode}) :\n{proc.stderr[-2000:]}")
+    return {
+        "execs": stats.get("number_of_executed_units", 0),
+        "execs_s": stats.get("average_exec_per_sec", 0),
+        "crash": crash.group(1) if crash else None,
+        "log": proc.stderr,
+    }
+
+
+def run_replay(binary: str, corpus: str, work: str) -> dict:
+    """Rejeu du corpus sous sanitizers : {"execs", "execs_s", "crash"}."""
+    paths = [corpus]
+    work_corpus = os.path.join(work, "corpus")
+    if os.path.isdir(work_corpus):
+        paths.append(work_corpus)
+
+    proc = subprocess.run(
+        [binary, *paths], stdin=subprocess.DEVNULL, capture_output=True, text=True,
+        encoding="utf-8", errors="replace", check=False,
+    )
+    m = RE_REPLAY.search(proc.stdout)
+    if proc.returncode != 0 or not m:
+        return {"execs": 0, "execs_s": 0, "crash": "rejeu", "log": proc.stderr}
+    return {"execs": int(m.group(1)), "execs_s": int(m.group(3)), "crash": None, "log": ""}
+
+
+# ==================================================
+# CONTRÔLE
+# ==================================================
+def run(binary: str, mode: str, env_name: str, corpus: str, work: str, seconds: int,
+        baseline_path: str, tolerance: float, regenerate: bool = False) -> int:
+    if not os.path.isfile(binary):
+        print(f"[fuzz_report] binaire introuvable : {binary} (pio run -e {env_name})")
+        return 1
+    if not os.path.isdir(corpus):
+        print(f"[fuzz_report] corpus introuvable : {corpus}")
+        return 1
+
+    if mode == "libfuzzer":
+        result = run_libfuzzer(binary, corpus, work, seconds)
+    else:
+        result = run_replay(binary, corpus, work)
+
+    if result["crash"]:
+        print(result["log"][-4000:])
+        print(f"[fuzz_report] CRASH : {result['crash']}")
+        return 1
+
+    baseline = {}
+    if os.path.isfile(baseline_path):
+        with open(baseline_path, encoding="utf-8") as f:
+            baseline = json.load(f)
+
+    if regenerate:
+        baseline[env_name] = {"mode": mode, "execs_s": result["execs_s"]}
+        with open(baseline_path, "w", encoding="utf-8") as f:
+            json.dump(baseline, f, indent=2)
+            f.write("\n")
+        print(f"[fuzz_report] référence {env_name} écrite : {baseline_path}")
+
+    ref = baseline.get(env_name, {}).get("execs_s")
+    delta = f" ({(result['execs_s'] - ref) / ref * 100:+.0f}% vs {ref})" if ref else ""
+    print(f"{env_name} [{mode}] : {result['execs']} exécutions, "
+          f"{result['execs_s']} exec/s{delta}, aucun crash")
+
+    if not ref:
+        print(f"[fuzz_report] AVERTISSEMENT : pas de référence de débit pour {env_name} dans "
+              f"{baseline_path} (à enregistrer : --write-baseline / pio run -t fuzz_baseline)")
+        return 0
+    floor = ref * (100 - tolerance) / 100
+    if result["execs_s"] < floor:
+        print(f"[fuzz_report] RÉGRESSION : {result['execs_s']} exec/s < {floor:.0f}")
+        return 1
+    return 0
+
+
+# ==================================================
+# INTÉGRATION PLATFORMIO (extra_scripts = pre:scripts/fuzz_report.py)
+# ==================================================
+try:
+    Import("env")  # noqa: F821  (fourni par SCons)
+except NameError:
+    env = None
+
+if env is not None:
+    env_mode = env.GetProjectOption("custom_fuzz_mode", "libfuzzer")
+    if env_mode == "libfuzzer":
+        # libFuzzer n'existe que sous clang ; sanitizers aussi à l'édition de liens
+        env.Replace(CC="clang", CXX="clang++")
+    env.Append(LINKFLAGS=[f for f in env.GetProjectOption("build_flags", "").split()
+                          if f.startswith("-fsanitize")])
+
+    def _fuzz_action(regenerate: bool):
+        def _fuzz(*_args, **_kwargs):
+            project = env.subst("$PROJECT_DIR")
+            code = run(
+                env.subst("$BUILD_DIR/${PROGNAME}"), env_mode, env.subst("$PIOENV"),
+                os.path.join(project, DEFAULT_CORPUS),
+                os.path.join(env.subst("$PROJECT_WORKSPACE_DIR"), "fuzz", env.subst("$PIOENV")),
+                int(env.GetProjectOption("custom_fuzz_seconds", "60")),
+                os.path.join(project, "fuzz_baseline.json"), 20.0, regenerate,
+            )
+            if code != 0:
+                env.Exit(1)
+        return _fuzz
+
+    env.AddCustomTarget(
+        name="fuzz",
+        dependencies="$BUILD_DIR/${PROGNAME}",
+        actions=[_fuzz_action(False)],
+        title="Serial fuzz",
+        description="Fuzzing trame JsonComm + dispatch, débit vs fuzz_baseline.json",
+    )
+    env.AddCustomTarget(
+        name="fuzz_baseline",
+        dependencies="$BUILD_DIR/${PROGNAME}",
+        actions=[_fuzz_action(True)],
+        title="Serial fuzz baseline",
+        description="Enregistre le débit de fuzzing dans fuzz_baseline.json",
+    )
+
+elif __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Fuzzing du lien série + débit")
+    parser.add_argument("binary", help="binaire SerialFuzz (libFuzzer ou FUZZ_STANDALONE)")
+    parser.add_argument("--mode", choices=("libfuzzer", "replay"), default="libfuzzer")
+    parser.add_argument("--env", help="clé de référence (défaut : native_fuzz / native_fuzz_replay)")
+    parser.add_argument("--seconds", type=int, default=60, help="durée de la campagne libFuzzer")
+    parser.add_argument("--corpus", default=DEFAULT_CORPUS, help="graines (lecture seule)")
+    parser.add_argument("--work", default=os.path.join(".pio", "fuzz"),
+                        help="corpus de travail + crashs")
+    parser.add_argument("--baseline", default="fuzz_baseline.json")
+    parser.add_argument("--tolerance", type=float, default=20.0,
+                        help="baisse de débit admise (%%)")
+    parser.add_argument("--write-baseline", action="store_true",
+                        help="enregistrer ce débit comme référence")
+    args = parser.parse_args()
+    env_name = args.env or ("native_fuzz" if args.mode == "libfuzzer" else "native_fuzz_replay")
+    sys.exit(run(args.binary, args.mode, env_name, args.corpus, args.work, args.seconds,
+                 args.baseline, args.tolerance, args.write_baseline))
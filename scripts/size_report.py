@@ -0,0 +1,302 @@
+"""
+size_report.py — Flash/RAM par module + contrôle du budget.
+
+Attribution par objet source grâce au fichier map de l'éditeur de liens :
+  - src/<module>/<Nom>.cpp.o   -> <Nom> (JsonComm, EEPROMStore, main, ...)
+  - lib*/<Lib>/...             -> <Lib> (MFRC522, SPI, ...)
+  - sections ArduinoJson::*    -> ArduinoJson (bibliothèque header-only)
+  - libFrameworkArduino.a      -> core
+  - libc / libgcc / libm       -> libc
+Sortie .text -> flash, .data -> flash + RAM, .bss/.noinit -> RAM.
+Les instances globales des modules sont définies dans main.cpp : leur RAM
+statique (buffers JsonComm, fenêtres de stats, ...) est comptée dans "main".
+
+Budget : size_budget.json à la racine du projet. Limites de la carte
+écrites à la main ; budgets par module toujours régénérés depuis une
+build réelle (mesure + marge), jamais édités. Le contrôle échoue si un
+total dépasse la limite de la carte, si la marge pile/tas
+(RAM - .data - .bss) descend sous min_stack_headroom, si un module
+dépasse son budget ou si un module n'a pas de budget (module ajouté
+depuis la régénération : régénérer). Tant que size_budget.json n'a pas
+de budgets par module, seules les limites de la carte sont contrôlées
+et un avertissement est affiché.
+
+Contrôle exécuté à chaque build de l'env (pio run), après l'édition de liens.
+
+Usage :
+  pio run                                   (build + contrôle)
+  pio run -t size_report                    (tableau détaillé)
+  pio run -t size_budget                    (régénère les budgets par module)
+  python scripts/size_report.py <firmware.map> [--budget size_budget.json]
+                                               [--write-budget] [--margin 10]
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+FLASH_SECTIONS = (".text",)
+DATA_SECTIONS = (".data",)
+RAM_SECTIONS = (".bss", ".noinit")
+
+# " .text.foo  0x0000000000000123  0x2c path/obj.o"
+RE_INPUT = re.compile(r"^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+RE_INPUT_NAME_ONLY = re.compile(r"^ (\S+)$")
+RE_OUTPUT = re.compile(r"^(\.\S+)(\s+0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+.*)?$")
+
+
+# ==================================================
+# PARSING MAP
+# ==================================================
+def module_of(obj: str, section: str) -> str:
+    if "ArduinoJson" in section:
+        return "ArduinoJson"
+
+    path = obj.replace("\\", "/")
+    base = os.path.basename(path)
+
+    if "libFrameworkArduino" in path or "/FrameworkArduino/" in path:
+        return "core"
+    if re.search(r"lib(c|gcc|m|printf_\w+)\.a", base) or "avr-libc" in path:
+        return "libc"
+
+    m = re.search(r"(?:^|/)src/(?:[^/]+/)*([^/]+?)\.(?:cpp|c)\.o$", path)
+    if m:
+        return m.group(1)
+
+    m = re.search(r"/lib[0-9a-fA-F]*/([^/]+)/", path)
+    if m:
+        return m.group(1)
+
+    # archive(objet.o)
+    m = re.match(r"(.+?)\((.+)\)$", path)
+    if m:
+        return os.path.splitext(os.path.basename(m.group(1)))[0].removeprefix("lib")
+
+    return "other"
+
+
+def parse_map(path: str) -> dict:
+    """Retourne {module: {"flash": n, "ram": n}}."""
+    modules: dict = {}
+    out_section = None
+    pending_name = None
+    in_map = False
+
+    def add(mod, flash, ram):
+        entry = modules.setdefault(mod, {"flash": 0, "ram": 0})
+        entry["flash"] += flash
+        entry["ram"] += ram
+
+    with open(path, encoding="utf-8", errors="ignore") as f:
+        for raw in f:
+            line = raw.rstrip("\n")
+
+            if line.startswith("Linker script and memory map"):
+                in_map = True
+                continue
+            if not in_map:
+                continue
+
+            m = RE_OUTPUT.match(line)
+            if m:
+                out_section = m.group(1)
+                pending_name = None
+                continue
+
+            if out_section is None:
+                continue
+
+            if line.startswith(" *fill*") or line.startswith(" *("):
+                continue
+
+            m = RE_INPUT_NAME_ONLY.match(line)
+            if m:
+                # nom de section trop long : adresse/taille à la ligne suivante
+                pending_name = m.group(1)
+                continue
+
+            m = RE_INPUT.match(line)
+            if not m:
+                pending_name = None
+                continue
+
+            name = m.group(1) or pending_name or ""
+            pending_name = None
+            size = int(m.group(3), 16)
+            obj = m.group(4).strip()
+            if size == 0 or obj.startswith("0x") or not name.startswith("."):
+                continue
+
+            mod = module_of(obj, name)
+            if out_section.startswith(FLASH_SECTIONS):
+                add(mod, size, 0)
+            elif out_section.startswith(DATA_SECTIONS):
+                add(mod, size, size)
+            elif out_section.startswith(RAM_SECTIONS):
+                add(mod, 0, size)
+
+    return modules
+
+
+# ==================================================
+# BUDGET
+# ==================================================
+def check(modules: dict, budget: dict) -> list:
+    errors = []
+    budgets = budget.get("modules", {})
+
+    # pas de budgets par module : limites de la carte seulement
+    for mod, usage in sorted(modules.items()) if budgets else ():
+        limit = budgets.get(mod)
+        if limit is None:
+            errors.append(f"{mod}: pas de budget (régénérer : pio run -t size_budget)")
+            continue
+        for kind in ("flash", "ram"):
+            if kind in limit and usage[kind] > limit[kind]:
+                errors.append(f"{mod}: {kind} {usage[kind]} > budget {limit[kind]}")
+
+    total_flash = sum(u["flash"] for u in modules.values())
+    total_ram = sum(u["ram"] for u in modules.values())
+
+    board = budget.get("board", {})
+    if "flash" in board and total_flash > board["flash"]:
+        errors.append(f"total flash {total_flash} > board {board['flash']}")
+    if "ram" in board:
+        headroom = board["ram"] - total_ram
+        need = budget.get("min_stack_headroom", 0)
+        if headroom < need:
+            errors.append(f"stack/heap headroom {headroom} < minimum {need}")
+
+    uno = budget.get("uno")
+    if uno and uno.get("enforce"):
+        if total_flash > uno["flash"]:
+            errors.append(f"UNO fit: flash {total_flash} > {uno['flash']}")
+        if uno["ram"] - total_ram < uno.get("min_stack_headroom", 0):
+            errors.append(f"UNO fit: headroom {uno['ram'] - total_ram} too small")
+
+    return errors
+
+
+def render(modules: dict, budget: dict) -> str:
+    budgets = budget.get("modules", {})
+    rows = [f"{'module':<16} {'flash':>8} {'budget':>8} {'ram':>6} {'budget':>7}"]
+    for mod, usage in sorted(modules.items(), key=lambda kv: -kv[1]["flash"]):
+        b = budgets.get(mod, {})
+        rows.append(
+            f"{mod:<16} {usage['flash']:>8} {b.get('flash', '-'):>8} "
+            f"{usage['ram']:>6} {b.get('ram', '-'):>7}"
+        )
+
+    total_flash = sum(u["flash"] for u in modules.values())
+    total_ram = sum(u["ram"] for u in modules.values())
+    rows.append(f"{'TOTAL':<16} {total_flash:>8} {'':>8} {total_ram:>6}")
+
+    board = budget.get("board", {})
+    if "ram" in board:
+        rows.append(
+            f"static RAM {total_ram}/{board['ram']} -> stack/heap headroom "
+            f"{board['ram'] - total_ram} (min {budget.get('min_stack_headroom', 0)})"
+        )
+    uno = budget.get("uno")
+    if uno:
+        fits = total_flash <= uno["flash"] and uno["ram"] - total_ram >= uno.get("min_stack_headroom", 0)
+        rows.append(f"UNO fit: {'yes' if fits else 'no'} "
+                    f"(flash {total_flash}/{uno['flash']}, ram {total_ram}/{uno['ram']})")
+    return "\n".join(rows)
+
+
+def write_budget(modules: dict, budget: dict, margin_pct: int) -> dict:
+    """Régénère les budgets par module : usage mesuré + marge (%)."""
+    out = dict(budget)
+    out["modules"] = {}
+    for mod, usage in sorted(modules.items()):
+        out["modules"][mod] = {
+            kind: int(usage[kind] * (100 + margin_pct) / 100) + 16
+            for kind in ("flash", "ram")
+        }
+    return out
+
+
+def run(map_path: str, budget_path: str, regenerate: bool = False, margin: int = 10) -> int:
+    if not os.path.isfile(map_path):
+        print(f"[size_report] map introuvable : {map_path}")
+        return 1
+
+    modules = parse_map(map_path)
+    budget = {}
+    if os.path.isfile(budget_path):
+        with open(budget_path, encoding="utf-8") as f:
+            budget = json.load(f)
+
+    if regenerate:
+        budget = write_budget(modules, budget, margin)
+        with open(budget_path, "w", encoding="utf-8") as f:
+            json.dump(budget, f, indent=2)
+            f.write("\n")
+        print(f"[size_report] budget écrit : {budget_path}")
+
+    print(render(modules, budget))
+
+    if not budget.get("modules"):
+        print(f"[size_report] AVERTISSEMENT : pas de budgets par module dans {budget_path}, "
+              f"limites de la carte seulement (à générer : pio run -t size_budget / --write-budget)")
+
+    errors = check(modules, budget)
+    for e in errors:
+        print(f"[size_report] BUDGET DÉPASSÉ : {e}")
+    return 1 if errors else 0
+
+
+# ==================================================
+# INTÉGRATION PLATFORMIO (extra_scripts = post:scripts/size_report.py)
+# ==================================================
+try:
+    Import("env")  # noqa: F821  (fourni par SCons)
+except NameError:
+    env = None
+
+if env is not None:
+    from SCons.Script import COMMAND_LINE_TARGETS  # noqa: E402
+
+    map_file = os.path.join(env.subst("$BUILD_DIR"), "firmware.map")
+    budget_file = os.path.join(env.subst("$PROJECT_DIR"), "size_budget.json")
+    env.Append(LINKFLAGS=["-Wl,-Map," + map_file])
+
+    def _size_action(regenerate: bool):
+        def _size_report(*_args, **_kwargs):
+            if run(map_file, budget_file, regenerate) != 0:
+                env.Exit(1)
+        return _size_report
+
+    # Build par défaut : contrôle après l'édition de liens (sauf régénération)
+    if "size_budget" not in COMMAND_LINE_TARGETS:
+        env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _size_action(False))
+
+    env.AddCustomTarget(
+        name="size_report",
+        dependencies="$BUILD_DIR/${PROGNAME}.elf",
+        actions=[_size_action(False)],
+        title="Size report",
+        description="Flash/RAM par module et contrôle de size_budget.json",
+    )
+    env.AddCustomTarget(
+        name="size_budget",
+        dependencies="$BUILD_DIR/${PROGNAME}.elf",
+        actions=[_size_action(True)],
+        title="Size budget",
+        description="Régénère les budgets par module de size_budget.json depuis cette build",
+    )
+
+elif __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Flash/RAM par module + budget")
+    parser.add_argument("map", help="fichier .map produit par l'éditeur de liens")
+    parser.add_argument("--budget", default="size_budget.json")
+    parser.add_argument("--write-budget", action="store_true",
+                        help="régénérer les budgets par module depuis cette build")
+    parser.add_argument("--margin", type=int, default=10,
+                        help="marge (%%) appliquée avec --write-budget")
+    args = parser.parse_args()
+    sys.exit(run(args.map, args.budget, args.write_budget, args.margin))
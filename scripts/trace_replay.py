@@ -0,0 +1,171 @@
+"""
+trace_replay.py — rejeu déterministe d'une trace d'entrées + contrôle de référence.
+
+Rejoue une trace (simulateur Linux --record) sur le build natif et compare
+à une référence enregistrée avec une version précédente du firmware :
+  - sorties : lignes émises sur Serial, broches, buzzer, horodatées en
+    horloge virtuelle -> identiques à l'octet près, sinon 1re divergence
+  - étapes LatencyTrace (detect -> uid -> lookup -> open_door -> relay) :
+    temps CPU hôte moyen par étape, meilleur de --runs rejeux, comparé à
+    la référence avec une tolérance (%) et un plancher absolu (µs)
+Chaque rejeu doit produire les mêmes sorties (contrôle du déterminisme).
+
+Usage :
+  pio run -e native_sim
+  .pio/build/native_sim/program --record session.trace   (session interactive)
+  python scripts/trace_replay.py session.trace --write-baseline
+  python scripts/trace_replay.py session.trace [--baseline fichier]
+                                 [--sim .pio/build/native_sim/program]
+                                 [--runs 3] [--tolerance 25] [--min-us 20]
+"""
+
+import argparse
+import difflib
+import json
+import os
+import subprocess
+import sys
+
+DEFAULT_SIM = os.path.join(".pio", "build", "native_sim", "program")
+CPU_PREFIX = "cpu "
+
+
+# ==================================================
+# REJEU
+# ==================================================
+def replay(sim: str, trace: str, settle_ms: int) -> tuple[list, dict]:
+    """Un rejeu : (lignes de sortie, {étape: {"n", "mean_us", "max_us"}})."""
+    proc = subprocess.run(
+        [sim, "--replay", trace, "--settle", str(settle_ms)],
+        stdin=subprocess.DEVNULL, capture_output=True, text=True,
+        encoding="utf-8", errors="replace", check=False,
+    )
+    if proc.returncode != 0:
+        raise RuntimeError(f"simulateur en erreur ({proc.returncode}) : {proc.stderr.strip()}")
+
+    outputs, stages = [], {}
+    for line in proc.stdout.splitlines():
+        if line.startswith(CPU_PREFIX):
+            name, *fields = line[len(CPU_PREFIX):].split()
+            stages[name] = {k: float(v) for k, v in (f.split("=", 1) for f in fields)}
+        else:
+            outputs.append(line)
+    return outputs, stages
+
+
+def best_of(runs: list) -> dict:
+    """Temps par étape : meilleure moyenne sur les rejeux (bruit de l'hôte)."""
+    best: dict = {}
+    for stages in runs:
+        for name, st in stages.items():
+            if name not in best or st["mean_us"] < best[name]["mean_us"]:
+                best[name] = st
+    return best
+
+
+# ==================================================
+# COMPARAISON
+# ==================================================
+def first_divergence(expected: list, actual: list, context: int = 3) -> str:
+    for i, (a, b) in enumerate(zip(expected, actual)):
+        if a != b:
+            break
+    else:
+        i = min(len(expected), len(actual))
+    lo = max(0, i - context)
+    diff = difflib.unified_diff(
+        expected[lo:i + context], actual[lo:i + context],
+        "référence", "rejeu", lineterm="", n=context,
+    )
+    return f"1re divergence ligne {i + 1} :\n" + "\n".join(diff)
+
+
+def check_stages(stages: dict, reference: dict, tolerance: float, min_us: float) -> list:
+    errors = []
+    for name, ref in reference.items():
+        cur = stages.get(name)
+        if cur is None:
+            errors.append(f"étape {name} absente du rejeu")
+            continue
+        limit = max(ref["mean_us"] * (100 + tolerance) / 100, ref["mean_us"] + min_us)
+        if cur["mean_us"] > limit:
+            errors.append(f"étape {name} : {cur['mean_us']:.1f} µs > {limit:.1f} µs "
+                          f"(référence {ref['mean_us']:.1f})")
+    return errors
+
+
+def render(stages: dict, reference: dict) -> str:
+    rows = [f"{'étape':<10} {'n':>5} {'cpu µs':>9} {'réf µs':>9} {'écart':>7}"]
+    for name, st in stages.items():
+        ref = reference.get(name, {}).get("mean_us")
+        delta = f"{(st['mean_us'] - ref) / ref * 100:+.0f}%" if ref else "-"
+        rows.append(f"{name:<10} {int(st['n']):>5} {st['mean_us']:>9.1f} "
+                    f"{ref if ref is not None else '-':>9} {delta:>7}")
+    return "\n".join(rows)
+
+
+def run(trace: str, baseline_path: str, sim: str, runs: int, settle_ms: int,
+        tolerance: float, min_us: float, regenerate: bool = False) -> int:
+    if not os.path.isfile(trace):
+        print(f"[trace_replay] trace introuvable : {trace}")
+        return 1
+    if not os.path.isfile(sim):
+        print(f"[trace_replay] simulateur introuvable : {sim} (pio run -e native_sim)")
+        return 1
+
+    results = [replay(sim, trace, settle_ms) for _ in range(max(1, runs))]
+    outputs = results[0][0]
+    for i, (other, _) in enumerate(results[1:], start=2):
+        if other != outputs:
+            print(f"[trace_replay] NON DÉTERMINISTE : rejeu {i} != rejeu 1")
+            print(first_divergence(outputs, other))
+            return 1
+    stages = best_of([s for _, s in results])
+
+    if regenerate:
+        with open(baseline_path, "w", encoding="utf-8") as f:
+            json.dump({"trace": os.path.basename(trace), "outputs": outputs, "stages": stages},
+                      f, indent=2, ensure_ascii=False)
+            f.write("\n")
+        print(f"[trace_replay] référence écrite : {baseline_path} ({len(outputs)} lignes)")
+        print(render(stages, stages))
+        return 0
+
+    if not os.path.isfile(baseline_path):
+        print(f"[trace_replay] référence introuvable : {baseline_path} (--write-baseline)")
+        return 1
+    with open(baseline_path, encoding="utf-8") as f:
+        baseline = json.load(f)
+
+    errors = []
+    if outputs != baseline["outputs"]:
+        errors.append("sorties différentes de la référence\n" +
+                      first_divergence(baseline["outputs"], outputs))
+    print(f"sorties : {len(outputs)} lignes, "
+          f"{'identiques' if outputs == baseline['outputs'] else 'DIFFÉRENTES'}")
+    print(render(stages, baseline.get("stages", {})))
+
+    errors += check_stages(stages, baseline.get("stages", {}), tolerance, min_us)
+    for e in errors:
+        print(f"[trace_replay] RÉGRESSION : {e}")
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Rejeu d'une trace d'entrées + référence")
+    parser.add_argument("trace", help="trace enregistrée par le simulateur (--record)")
+    parser.add_argument("--baseline", help="référence (défaut : <trace>.baseline.json)")
+    parser.add_argument("--sim", default=DEFAULT_SIM, help="binaire du simulateur natif")
+    parser.add_argument("--runs", type=int, default=3,
+                        help="rejeux (déterminisme + meilleur temps CPU)")
+    parser.add_argument("--settle", type=int, default=2000,
+                        help="ms simulées après la dernière entrée")
+    parser.add_argument("--tolerance", type=float, default=25.0,
+                        help="dépassement admis du temps CPU par étape (%%)")
+    parser.add_argument("--min-us", type=float, default=20.0,
+                        help="dépassement toujours admis (µs), bruit de mesure")
+    parser.add_argument("--write-baseline", action="store_true",
+                        help="enregistrer ce rejeu comme référence")
+    args = parser.parse_args()
+    sys.exit(run(args.trace, args.baseline or args.trace + ".baseline.json", args.sim,
+                 args.runs, args.settle, args.tolerance, args.min_us, args.write_baseline))
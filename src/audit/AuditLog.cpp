@@ -0,0 +1,202 @@
+#include "AuditLog.h"
+#include <EEPROM.h>
+#if defined(ARDUINO_ARCH_AVR)
+#include <avr/eeprom.h>
+#endif
+
+AuditLog::AuditLog(EEPROMStore &storeRef, const SoftClock &clockRef)
+    : store(storeRef),
+      clock(clockRef),
+      base(0),
+      head(0),
+      count(0),
+      lastSeq(0),
+      nextSeq(0),
+      qHead(0),
+      qCount(0),
+      dropped(0),
+      writePos(RECORD_SIZE)
+{
+}
+
+void AuditLog::begin() {
+    base = store.auditLogOffset();
+
+    // Plus récent = plus grand seq (arithmétique modulo 2^16)
+    int16_t newest = -1;
+    Pending rec, best = {0, 0, 0, 0};
+    for (uint8_t i = 0; i < AUDIT_RECORDS; i++) {
+        if (!readRecord(i, rec)) continue;
+        if (newest < 0 || (int16_t)(rec.seq - best.seq) > 0) {
+            newest = i;
+            best = rec;
+        }
+    }
+
+    if (newest < 0) {
+        head = 0;
+        count = 0;
+        lastSeq = 0xFFFF;
+        nextSeq = 0;
+        DEBUG_PRINTLN(F("[AUDIT] Journal vide"));
+        return;
+    }
+
+    head = (newest + 1) % AUDIT_RECORDS;
+    lastSeq = best.seq;
+    nextSeq = best.seq + 1;
+
+    // Remonter la suite contiguë de seq (un enregistrement coupé l'interrompt)
+    count = 1;
+    uint8_t idx = newest;
+    while (count < AUDIT_RECORDS) {
+        idx = idx == 0 ? AUDIT_RECORDS - 1 : idx - 1;
+        if (!readRecord(idx, rec) || rec.seq != (uint16_t)(lastSeq - count)) break;
+        count++;
+    }
+
+    DEBUG_PRINT(F("[AUDIT] Enregistrements : "));
+    DEBUG_PRINTLN(count);
+}
+
+void AuditLog::log(const uint8_t *uid, uint8_t reader, AuditDecision decision) {
+    if (qCount >= AUDIT_QUEUE_SIZE) {
+        dropped++;
+        return;
+    }
+
+    Pending &p = queue[(qHead + qCount) % AUDIT_QUEUE_SIZE];
+    p.seq = nextSeq++;
+    p.uidHash = uid ? hashUID(uid) : 0;
+    p.flags = ((uint8_t)decision & 0x07) | ((reader & 0x03) << 3);
+    if (clock.isSynced()) {
+        p.ts = clock.now();
+        p.flags |= 0x80;
+    } else {
+        p.ts = millis() / 1000UL;
+    }
+    qCount++;
+}
+
+void AuditLog::update() {
+    if (writePos >= RECORD_SIZE) {
+        if (qCount == 0) return;
+        encode(queue[qHead], image);
+        qHead = (qHead + 1) % AUDIT_QUEUE_SIZE;
+        qCount--;
+        writePos = 0;
+        // anneau plein : le plus ancien est en cours d'écrasement
+        if (count == AUDIT_RECORDS) count--;
+    }
+
+    // Une écriture d'octet EEPROM dure ~3,3 ms : ne jamais l'attendre
+#if defined(ARDUINO_ARCH_AVR)
+    if (!eeprom_is_ready()) return;
+#endif
+
+    EEPROM.update(slotAddr(head) + writePos, image[writePos]);
+    writePos++;
+
+    if (writePos >= RECORD_SIZE) {
+        // check écrit en dernier : un enregistrement coupé reste invalide
+        head = (head + 1) % AUDIT_RECORDS;
+        count++;
+        lastSeq = (uint16_t)image[0] | ((uint16_t)image[1] << 8);
+    }
+}
+
+bool AuditLog::isIdle() const {
+    return qCount == 0 && writePos >= RECORD_SIZE;
+}
+
+uint16_t AuditLog::oldestSeq() const {
+    return lastSeq - count + 1;
+}
+
+uint16_t AuditLog::attachChunk(JsonObject out, uint16_t cursor) const {
+    uint16_t oldest = oldestSeq();
+    uint16_t behind = (uint16_t)(lastSeq + 1 - cursor);
+
+    // Curseur trop ancien (écrasé) ou inconnu : reprendre au plus ancien
+    if (behind > count) {
+        cursor = oldest;
+        behind = count;
+    }
+
+    out["first"] = oldest;
+    JsonArray records = out.createNestedArray("records");
+
+    uint8_t n = 0;
+    while (behind > 0 && n < AUDIT_CHUNK) {
+        // emplacement du seq "cursor" : head - behind
+        uint8_t idx = (head + AUDIT_RECORDS - behind) % AUDIT_RECORDS;
+        Pending rec;
+        if (readRecord(idx, rec) && rec.seq == cursor) {
+            JsonArray r = records.createNestedArray();
+            r.add(rec.seq);
+            r.add(rec.ts);
+            r.add(rec.uidHash);
+            r.add((rec.flags >> 3) & 0x03);
+            r.add(rec.flags & 0x07);
+            r.add((rec.flags & 0x80) != 0);
+        }
+        cursor++;
+        behind--;
+        n++;
+    }
+
+    out["next"] = cursor;
+    out["more"] = behind > 0;
+    return cursor;
+}
+
+void AuditLog::attachStats(JsonObject out) const {
+    out["records"] = count;
+    out["pending"] = qCount + (writePos < RECORD_SIZE ? 1 : 0);
+    out["dropped"] = dropped;
+}
+
+uint16_t AuditLog::hashUID(const uint8_t *uid) {
+    uint32_t h = 2166136261UL;
+    for (uint8_t i = 0; i < EEPROMStore::UID_SIZE; i++) {
+        h ^= uid[i];
+        h *= 16777619UL;
+    }
+    return (uint16_t)(h >> 16) ^ (uint16_t)h;
+}
+
+/* ----- encodage ----- */
+
+uint16_t AuditLog::slotAddr(uint8_t index) const {
+    return base + (uint16_t)index * RECORD_SIZE;
+}
+
+uint8_t AuditLog::checksum(const uint8_t *buf) {
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < RECORD_SIZE - 1; i++) sum += buf[i];
+    return ~sum; // ni 0x00 ni 0xFF partout ne sont valides
+}
+
+void AuditLog::encode(const Pending &rec, uint8_t *buf) {
+    buf[0] = rec.seq & 0xFF;
+    buf[1] = rec.seq >> 8;
+    for (uint8_t i = 0; i < 4; i++) buf[2 + i] = (rec.ts >> (8 * i)) & 0xFF;
+    buf[6] = rec.uidHash & 0xFF;
+    buf[7] = rec.uidHash >> 8;
+    buf[8] = rec.flags;
+    buf[9] = checksum(buf);
+}
+
+bool AuditLog::readRecord(uint8_t index, Pending &rec) const {
+    uint8_t buf[RECORD_SIZE];
+    uint16_t addr = slotAddr(index);
+    for (uint8_t i = 0; i < RECORD_SIZE; i++) buf[i] = EEPROM.read(addr + i);
+    if (buf[9] != checksum(buf)) return false;
+
+    rec.seq = (uint16_t)buf[0] | ((uint16_t)buf[1] << 8);
+    rec.ts = 0;
+    for (uint8_t i = 0; i < 4; i++) rec.ts |= (uint32_t)buf[2 + i] << (8 * i);
+    rec.uidHash = (uint16_t)buf[6] | ((uint16_t)buf[7] << 8);
+    rec.flags = buf[8];
+    return true;
+}
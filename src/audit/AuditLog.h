@@ -0,0 +1,92 @@
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+#include "../eeprom/EEPROMStore.h"
+#include "../schedule/SoftClock.h"
+
+/*
+  AuditLog
+  - Journal des décisions d'accès, persistant (anneau en EEPROM)
+  - Enregistrement fixe de RECORD_SIZE octets :
+      seq (u16) | ts (u32) | hash UID (u16) | flags (u8) | check (u8)
+    flags : bits 0-2 décision, bits 3-4 lecteur, bit 7 = ts en heure
+    locale (horloge synchronisée), sinon secondes depuis le boot
+  - UID non stocké en clair : hash FNV-1a 32 bits replié sur 16 bits
+  - Usure répartie : écriture séquentielle sur tout l'anneau, tête
+    retrouvée au boot par le plus grand numéro de séquence
+  - log() ne touche pas l'EEPROM (file RAM) ; update() écrit un octet
+    au plus par appel et seulement si l'EEPROM est prête : jamais
+    d'attente sur le chemin d'ouverture
+  - attachChunk() : lecture par bloc avec curseur de reprise (seq)
+*/
+
+enum class AuditDecision : uint8_t {
+    GRANTED = 0,
+    DENIED_UNKNOWN = 1,
+    DENIED_SCHEDULE = 2,
+    DENIED_CLOCK = 3,
+    MANUAL_OPEN = 4,
+    DENIED_ROLE = 5,
+    ADMIN_CARD = 6
+};
+
+class AuditLog {
+public:
+    static const uint8_t RECORD_SIZE = EEPROMStore::AUDIT_RECORD_SIZE;
+
+    AuditLog(EEPROMStore &store, const SoftClock &clock);
+
+    void begin();
+    void update();
+
+    // uid peut être nullptr (ouverture manuelle)
+    void log(const uint8_t *uid, uint8_t reader, AuditDecision decision);
+
+    // Remplit out avec au plus AUDIT_CHUNK enregistrements à partir de cursor.
+    // Renvoie le curseur suivant.
+    uint16_t attachChunk(JsonObject out, uint16_t cursor) const;
+    uint16_t oldestSeq() const;
+    void attachStats(JsonObject out) const;
+
+    bool isIdle() const;
+
+    static uint16_t hashUID(const uint8_t *uid);
+
+private:
+    struct Pending {
+        uint16_t seq;
+        uint32_t ts;
+        uint16_t uidHash;
+        uint8_t flags;
+    };
+
+    EEPROMStore &store;
+    const SoftClock &clock;
+    uint16_t base;
+
+    // anneau EEPROM
+    uint8_t head;           // prochain emplacement écrit
+    uint8_t count;          // enregistrements valides
+    uint16_t lastSeq;       // seq du plus récent enregistrement écrit
+    uint16_t nextSeq;
+
+    // file RAM
+    Pending queue[AUDIT_QUEUE_SIZE];
+    uint8_t qHead;
+    uint8_t qCount;
+    uint16_t dropped;
+
+    // écriture en cours, octet par octet
+    uint8_t image[RECORD_SIZE];
+    uint8_t writePos;       // RECORD_SIZE = rien en cours
+
+    bool readRecord(uint8_t index, Pending &rec) const;
+    static uint8_t checksum(const uint8_t *buf);
+    static void encode(const Pending &rec, uint8_t *buf);
+    uint16_t slotAddr(uint8_t index) const;
+};
+
+#endif // AUDIT_LOG_H
@@ -0,0 +1,111 @@
+#include "LockoutPolicy.h"
+
+static const uint8_t MAX_LEVEL = 16;
+
+LockoutPolicy::LockoutPolicy(EEPROMStore &storeRef)
+    : store(storeRef),
+      maxAttempts(LOCKOUT_MAX_ATTEMPTS),
+      baseSec(LOCKOUT_DEFAULT_SEC)
+{
+    memset(states, 0, sizeof(states));
+}
+
+void LockoutPolicy::begin() {
+    for (uint8_t i = 0; i < (uint8_t)AuthSource::COUNT; i++) {
+        SourceState &st = states[i];
+        store.readLockout(i, st.failures, st.level);
+
+        // bloquée avant la coupure : nouvelle fenêtre complète
+        if (st.failures >= maxAttempts && st.level > 0) {
+            st.locked = true;
+            st.lockedAtMs = millis();
+            st.windowMs = windowFor(st.level);
+            DEBUG_PRINT(F("[LOCKOUT] Source bloquée au boot: "));
+            DEBUG_PRINTLN(i);
+        }
+    }
+}
+
+void LockoutPolicy::setPolicy(uint8_t attempts, uint16_t seconds) {
+    maxAttempts = attempts ? attempts : 1;
+    baseSec = seconds ? seconds : 1;
+}
+
+bool LockoutPolicy::isLocked(AuthSource s) {
+    SourceState &st = states[(uint8_t)s];
+    if (!st.locked) return false;
+
+    if ((millis() - st.lockedAtMs) < st.windowMs) return true;
+
+    // fenêtre écoulée : nouvelle série d'essais, niveau conservé
+    st.locked = false;
+    st.failures = 0;
+    store.writeLockout((uint8_t)s, 0, st.level);
+    DEBUG_PRINTLN(F("[LOCKOUT] Blocage levé"));
+    return false;
+}
+
+unsigned long LockoutPolicy::remainingMs(AuthSource s) {
+    if (!isLocked(s)) return 0;
+    const SourceState &st = states[(uint8_t)s];
+    return st.windowMs - (millis() - st.lockedAtMs);
+}
+
+uint8_t LockoutPolicy::remainingAttempts(AuthSource s) const {
+    const SourceState &st = states[(uint8_t)s];
+    if (st.locked || st.failures >= maxAttempts) return 0;
+    return maxAttempts - st.failures;
+}
+
+void LockoutPolicy::onFailure(AuthSource s) {
+    uint8_t i = (uint8_t)s;
+    SourceState &st = states[i];
+    if (st.locked) return;
+
+    if (st.failures < 0xFF) st.failures++;
+    if (st.failures >= maxAttempts) {
+        lock(i);
+    } else {
+        store.writeLockout(i, st.failures, st.level);
+    }
+}
+
+void LockoutPolicy::onSuccess(AuthSource s) {
+    uint8_t i = (uint8_t)s;
+    SourceState &st = states[i];
+    st.failures = 0;
+    st.level = 0;
+    st.locked = false;
+    store.writeLockout(i, 0, 0);
+}
+
+void LockoutPolicy::attachStats(JsonObject out) {
+    static const char *const names[] = { "keypad", "serial" };
+    for (uint8_t i = 0; i < (uint8_t)AuthSource::COUNT; i++) {
+        JsonObject o = out.createNestedObject(names[i]);
+        o["level"] = states[i].level;
+        o["locked_s"] = remainingMs((AuthSource)i) / 1000UL;
+        o["attempts_left"] = remainingAttempts((AuthSource)i);
+    }
+}
+
+/* ----- interne ----- */
+
+void LockoutPolicy::lock(uint8_t i) {
+    SourceState &st = states[i];
+    if (st.level < MAX_LEVEL) st.level++;
+    st.locked = true;
+    st.lockedAtMs = millis();
+    st.windowMs = windowFor(st.level);
+    store.writeLockout(i, st.failures, st.level);
+
+    DEBUG_PRINT(F("[LOCKOUT] Source bloquée (s): "));
+    DEBUG_PRINTLN(st.windowMs / 1000UL);
+}
+
+unsigned long LockoutPolicy::windowFor(uint8_t level) const {
+    unsigned long sec = baseSec;
+    for (uint8_t l = 1; l < level && sec < LOCKOUT_MAX_SEC; l++) sec <<= 1;
+    if (sec > LOCKOUT_MAX_SEC) sec = LOCKOUT_MAX_SEC;
+    return sec * 1000UL;
+}
@@ -0,0 +1,61 @@
+#ifndef LOCKOUT_POLICY_H
+#define LOCKOUT_POLICY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+#include "../eeprom/EEPROMStore.h"
+
+/*
+  LockoutPolicy
+  - Anti force brute du PIN admin, compteurs séparés par source
+    (clavier / série) : un PIN raté au clavier ne bloque pas l'hôte
+  - Après maxAttempts échecs : blocage base, puis 2x, 4x... (LOCKOUT_MAX_SEC)
+    le niveau ne retombe qu'après un PIN correct
+  - Échecs et niveau persistés en EEPROM : au redémarrage une source bloquée
+    repart pour une fenêtre complète (pas d'horloge fiable au boot),
+    couper le courant ne lève jamais un blocage
+  - isLocked() : O(1), millis() uniquement, jamais bloquant
+*/
+
+enum class AuthSource : uint8_t {
+    KEYPAD,
+    SERIAL_LINK,
+    COUNT
+};
+
+class LockoutPolicy {
+public:
+    explicit LockoutPolicy(EEPROMStore &store);
+
+    void begin();
+    void setPolicy(uint8_t maxAttempts, uint16_t baseSec);
+
+    bool isLocked(AuthSource s);
+    unsigned long remainingMs(AuthSource s);
+    uint8_t remainingAttempts(AuthSource s) const;
+
+    void onFailure(AuthSource s);
+    void onSuccess(AuthSource s);
+
+    void attachStats(JsonObject out);
+
+private:
+    struct SourceState {
+        uint8_t failures;
+        uint8_t level;          // nb de blocages consécutifs
+        bool locked;
+        unsigned long lockedAtMs;
+        unsigned long windowMs;
+    };
+
+    EEPROMStore &store;
+    uint8_t maxAttempts;
+    uint16_t baseSec;
+    SourceState states[(uint8_t)AuthSource::COUNT];
+
+    void lock(uint8_t i);
+    unsigned long windowFor(uint8_t level) const;
+};
+
+#endif // LOCKOUT_POLICY_H
@@ -0,0 +1,442 @@
+/*
+  JsonCommBench — débit et pile de JsonComm (réception + émission)
+  - Réception : receiveCommand() sur des trames réalistes (cmd court, id
+    long, id absent, trame fragmentée, rafale, JSON invalide, ligne trop
+    longue), servies par un flux mémoire au lieu de Serial.
+  - Émission : sendResponse() sur chaque forme de réponse de main.cpp,
+    sendAck() / sendError().
+  - Par cas : messages/s, octets/s, ns par message (cycles sur AVR) et pic
+    de pile (zone peinte sous le cadre appelant).
+  - Sortie : une ligne "bench <cas> ..." par cas, comparée à
+    bench_baseline.json par scripts/bench_report.py.
+
+  Hôte : pio run -e native_bench -t bench
+  Carte (ou simavr) : pio run -e mega_bench -t upload, sortie sur Serial
+*/
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+#include "../comm/JsonComm.h"
+
+#ifndef BENCH_MIN_MS
+#define BENCH_MIN_MS 500UL         // durée de mesure minimale par cas
+#endif
+
+#if defined(ARDUINO_ARCH_AVR)
+#define BENCH_ENV "mega2560"
+#define BENCH_STACK_PROBE 2048     // octets peints sous le cadre du banc
+#else
+#define BENCH_ENV "native"
+#define BENCH_STACK_PROBE 8192
+#endif
+#define BENCH_PAINT 0xA5
+
+/* ===== FLUX MÉMOIRE ===== */
+
+// Entrée : octets "arrivés" par fenêtres de chunk octets ; sortie : comptée puis jetée
+class BenchStream : public Stream {
+public:
+    void load(const char *data, size_t chunkSize) {
+        in = data;
+        inLen = strlen(data);
+        chunk = chunkSize ? chunkSize : inLen;
+        rewind();
+    }
+    void rewind() {
+        pos = 0;
+        window = chunk < inLen ? chunk : inLen;
+    }
+    void nextChunk() {
+        window = (pos + chunk) < inLen ? pos + chunk : inLen;
+    }
+    bool drained() const { return pos >= inLen; }
+    size_t inputLength() const { return inLen; }
+
+    int available() override { return (int)(window - pos); }
+    int read() override { return pos < window ? (uint8_t)in[pos++] : -1; }
+    int peek() override { return pos < window ? (uint8_t)in[pos] : -1; }
+    size_t write(uint8_t) override {
+        out++;
+        return 1;
+    }
+    size_t write(const uint8_t *, size_t n) override {
+        out += n;
+        return n;
+    }
+    using Print::write;
+
+    unsigned long out = 0;
+
+private:
+    const char *in = "";
+    size_t inLen = 0;
+    size_t chunk = 0;
+    size_t pos = 0;
+    size_t window = 0;
+};
+
+static BenchStream stream;
+static JsonComm comm(stream);
+
+/* ===== PILE ===== */
+
+// Même profondeur d'appel pour peindre et relire : les deux zones coïncident
+__attribute__((noinline)) static void paintStack() {
+    volatile uint8_t area[BENCH_STACK_PROBE];
+    for (size_t i = 0; i < sizeof(area); i++) area[i] = BENCH_PAINT;
+}
+
+__attribute__((noinline)) static size_t stackUsed() {
+    uint8_t area[BENCH_STACK_PROBE];   // non initialisée : relit la peinture laissée en place
+    volatile uint8_t *p = area;
+    size_t i = 0;
+    while (i < sizeof(area) && p[i] == BENCH_PAINT) i++;   // area[0] : le plus profond
+    return sizeof(area) - i;
+}
+
+/* ===== RAPPORT ===== */
+
+static void emit(const char *line) {
+#if defined(ARDUINO_ARCH_AVR)
+    Serial.println(line);
+#else
+    puts(line);
+#endif
+}
+
+static void report(const char *name, unsigned long msgs, unsigned long bytes,
+                   unsigned long elapsedUs, size_t stack) {
+    if (elapsedUs == 0) elapsedUs = 1;
+    char line[160];
+    // ns par message en 64 bits : us * 1000 déborde en 32 bits sur AVR
+    unsigned long nsMsg = (unsigned long)((unsigned long long)elapsedUs * 1000ULL / msgs);
+    snprintf(line, sizeof(line), "bench %s msgs_s=%lu bytes_s=%lu ns_msg=%lu stack=%u",
+             name,
+             (unsigned long)((unsigned long long)msgs * 1000000ULL / elapsedUs),
+             (unsigned long)((unsigned long long)bytes * 1000000ULL / elapsedUs),
+             nsMsg, (unsigned)stack);
+#if defined(ARDUINO_ARCH_AVR)
+    size_t n = strlen(line);
+    snprintf(line + n, sizeof(line) - n, " cycles_msg=%lu",
+             (unsigned long)((unsigned long long)nsMsg * (F_CPU / 1000000UL) / 1000ULL));
+#endif
+    emit(line);
+}
+
+/* ===== RÉCEPTION ===== */
+
+struct RxCase {
+    const char *name;
+    const char *data;      // trame(s) terminée(s) par '\n'
+    size_t chunk;          // octets disponibles par appel (0 = tout d'un coup)
+};
+
+static const RxCase RX_CASES[] = {
+    { "rx_short",      "{\"cmd\":\"stats\"}\n", 0 },
+    { "rx_long_id",    "{\"cmd\":\"1234#\",\"id\":\"hub-0123456789\"}\n", 0 },
+    { "rx_pin_cmd",    "{\"cmd\":\"123\",\"id\":\"h42\"}\n", 0 },
+    { "rx_fragmented", "{\"cmd\":\"audit:1234\",\"id\":\"h999999\"}\n", 8 },
+    { "rx_burst",      "{\"cmd\":\"stats\",\"id\":\"h1\"}\n{\"cmd\":\"config\",\"id\":\"h2\"}\n"
+                       "{\"cmd\":\"123\",\"id\":\"h3\"}\n{\"cmd\":\"101\",\"id\":\"h4\"}\n", 0 },
+    { "rx_invalid",    "{\"cmd\":\"stats\",\"id\":h5}\n", 0 },
+    { "rx_not_object", "[\"stats\",\"h6\"]\n", 0 },
+    { "rx_overflow",   "{\"cmd\":\"0123456789012345678901234567890123456789012345678901234567890123"
+                       "456789012345678901234567890123456789012345678901234567890123456789"
+                       "012345678901234567890123456789012345678901234567890123456789012345"
+                       "6789012345678901234567890123456789012345678901234567890123\"}\n", 0 },
+};
+
+static unsigned long countFrames(const char *data) {
+    unsigned long n = 0;
+    for (const char *p = data; *p; p++) {
+        if (*p == '\n') n++;
+    }
+    return n;
+}
+
+// Une itération : toute l'entrée, fenêtre par fenêtre, jusqu'à vidage
+static void rxOnce(StaticJsonDocument<256> &doc) {
+    stream.rewind();
+    while (!stream.drained()) {
+        if (stream.available() == 0) stream.nextChunk();
+        comm.receiveCommand(doc);
+    }
+}
+
+__attribute__((noinline)) static void rxProbe(StaticJsonDocument<256> &doc) {
+    rxOnce(doc);
+}
+
+static void benchRx(const RxCase &c) {
+    StaticJsonDocument<256> doc;
+    stream.load(c.data, c.chunk);
+
+    paintStack();
+    rxProbe(doc);
+    size_t stack = stackUsed();
+
+    unsigned long iterations = 0;
+    unsigned long t0 = micros();
+    unsigned long elapsed;
+    do {
+        rxOnce(doc);
+        iterations++;
+        elapsed = micros() - t0;
+    } while (elapsed < BENCH_MIN_MS * 1000UL);
+
+    report(c.name, iterations * countFrames(c.data), iterations * stream.inputLength(), elapsed, stack);
+}
+
+/* ===== ÉMISSION : formes de réponse de main.cpp ===== */
+
+static void shapeDoorState(JsonDocument &doc) {
+    doc["type"] = "door_state";
+    doc["door"] = 0;
+    doc["state"] = "opened";
+    doc["id"] = "evt-4294967295";
+}
+
+static void shapeBadge(JsonDocument &doc) {
+    doc["status"] = "success";
+    doc["type"] = "badge";
+    doc["access_granted"] = true;
+    doc["reader"] = 0;
+    doc["roles"] = 5;
+    JsonObject t = doc.createNestedObject("trace");
+    t["detect"] = 0;
+    t["uid"] = 1840;
+    t["lookup"] = 2112;
+    doc["id"] = "evt-123456";
+}
+
+static void shapeAdminAuth(JsonDocument &doc) {
+    doc["status"] = "error";
+    doc["type"] = "admin_auth";
+    doc["access_granted"] = false;
+    doc["source"] = "serial";
+    doc["locked"] = true;
+    doc["retry_in_s"] = 240;
+    doc["id"] = "hub-0123456789";
+}
+
+static void shapeCommand(JsonDocument &doc) {
+    doc["type"] = "command";
+    doc["status"] = "success";
+    doc["action"] = "open_door";
+    doc["door"] = 1;
+    doc["id"] = "h999999";
+}
+
+static void shapeCommandError(JsonDocument &doc) {
+    doc["type"] = "command";
+    doc["status"] = "error";
+    doc["message"] = "PIN length must be 3-6 digits";
+    doc["id"] = "h999999";
+}
+
+static void shapeScanRequired(JsonDocument &doc) {
+    doc["type"] = "command";
+    doc["status"] = "scan_required";
+    doc["command"] = "add_badge";
+    doc["id"] = "h12";
+}
+
+static void shapeConfig(JsonDocument &doc) {
+    doc["type"] = "config";
+    doc["status"] = "success";
+    doc["eeprom_version"] = 3;
+    JsonObject c = doc.createNestedObject("config");
+    c["open_ms"] = 5000;
+    c["max_attempts"] = 3;
+    c["lockout_s"] = 30;
+    c["reader_profile"] = 1;
+    doc["id"] = "h7";
+}
+
+static void shapeBoot(JsonDocument &doc) {
+    doc["type"] = "boot";
+    doc["reset_reason"] = "watchdog";
+    doc["culprit"] = "rfid";
+    JsonObject m = doc.createNestedObject("deadline_misses");
+    m["rfid"] = 3;
+    m["relay"] = 0;
+    m["serial"] = 1;
+    doc["id"] = "evt-1";
+}
+
+static void shapeMem(JsonDocument &doc) {
+    doc["type"] = "mem";
+    doc["status"] = "success";
+    doc["free_ram"] = 2310;
+    doc["min_free"] = 1874;
+    JsonObject st = doc.createNestedObject("stack");
+    st["peak"] = 1204;
+    st["stage"] = "serial";
+    JsonObject hp = doc.createNestedObject("heap");
+    hp["peak"] = 612;
+    hp["largest_free"] = 2280;
+    hp["stage"] = "housekeeping";
+    doc["id"] = "h8";
+}
+
+static void shapeAudit(JsonDocument &doc) {
+    doc["type"] = "audit";
+    doc["status"] = "success";
+    doc["first"] = 60000;
+    JsonArray records = doc.createNestedArray("records");
+    for (uint8_t i = 0; i < AUDIT_CHUNK; i++) {
+        JsonArray r = records.createNestedArray();
+        r.add(60000 + i);
+        r.add(1767225600UL + i * 37UL);
+        r.add(0xBEEF ^ i);
+        r.add(i & 0x03);
+        r.add(i % 6);
+        r.add(i == 0);
+    }
+    doc["next"] = 60000 + AUDIT_CHUNK;
+    doc["more"] = true;
+    doc["id"] = "h31";
+}
+
+static void shapeStats(JsonDocument &doc) {
+    doc["type"] = "stats";
+    doc["status"] = "success";
+
+    JsonObject lat = doc.createNestedObject("latency");
+    lat["n"] = 32;
+    lat["p50_us"] = 2210;
+    lat["p99_us"] = 5120;
+
+    JsonObject pwr = doc.createNestedObject("power");
+    pwr["idle_pct"] = 97;
+    pwr["sleep_ms"] = 86123456UL;
+    pwr["wakeups"] = 123456UL;
+
+    JsonObject h = doc.createNestedObject("health");
+    h["reset_reason"] = "power_on";
+    JsonObject m = h.createNestedObject("deadline_misses");
+    m["rfid"] = 0;
+    m["relay"] = 2;
+    m["serial"] = 0;
+
+    JsonArray rl = doc.createNestedArray("rfid");
+    for (uint8_t i = 0; i < RFID_READER_COUNT; i++) {
+        JsonObject r = rl.createNestedObject();
+        r["reader"] = i;
+        r["online"] = true;
+        r["mode"] = "polling";
+        r["exchanges"] = 1234567UL;
+        r["busy_us"] = 987654321UL;
+        r["reads"] = 4321;
+        r["suppressed"] = 120;
+        r["read_errors"] = 3;
+        r["detect_latency_us"] = 1840;
+    }
+
+    JsonObject uc = doc.createNestedObject("uid_cache");
+    uc["hits"] = 4000;
+    uc["misses"] = 321;
+
+    JsonObject au = doc.createNestedObject("audit");
+    au["records"] = 200;
+    au["pending"] = 1;
+    au["dropped"] = 0;
+
+    JsonObject lo = doc.createNestedObject("lockout");
+    static const char *const sources[] = { "keypad", "serial" };
+    for (uint8_t i = 0; i < 2; i++) {
+        JsonObject o = lo.createNestedObject(sources[i]);
+        o["level"] = i;
+        o["locked_s"] = 0;
+        o["attempts_left"] = 3;
+    }
+
+    JsonObject kp = doc.createNestedObject("keypad");
+    kp["dropped"] = 0;
+    kp["max_depth"] = 4;
+    kp["max_lag_ms"] = 12;
+
+    JsonObject clk = doc.createNestedObject("clock");
+    clk["synced"] = true;
+    clk["epoch"] = 1767225600UL;
+
+    doc["id"] = "h100";
+}
+
+struct TxCase {
+    const char *name;
+    void (*build)(JsonDocument &doc);   // nullptr : sendAck / sendError
+};
+
+static const TxCase TX_CASES[] = {
+    { "tx_door_state",    shapeDoorState },
+    { "tx_badge",         shapeBadge },
+    { "tx_admin_auth",    shapeAdminAuth },
+    { "tx_command",       shapeCommand },
+    { "tx_command_error", shapeCommandError },
+    { "tx_scan_required", shapeScanRequired },
+    { "tx_config",        shapeConfig },
+    { "tx_boot",          shapeBoot },
+    { "tx_mem",           shapeMem },
+    { "tx_audit",         shapeAudit },
+    { "tx_stats",         shapeStats },
+    { "tx_ack",           nullptr },
+    { "tx_error",         nullptr },
+};
+
+static void txOnce(const TxCase &c, const JsonDocument &doc) {
+    if (c.build) comm.sendResponse(doc);
+    else if (c.name[3] == 'a') comm.sendAck("hub-0123456789", "ok");
+    else comm.sendError("hub-0123456789", "invalid_cmd");
+}
+
+__attribute__((noinline)) static void txProbe(const TxCase &c, const JsonDocument &doc) {
+    txOnce(c, doc);
+}
+
+static void benchTx(const TxCase &c) {
+    // Document construit une fois (coût de main.cpp) : seule l'émission est mesurée
+    StaticJsonDocument<640 + 128 * RFID_READER_COUNT> doc;
+    if (c.build) c.build(doc);
+
+    paintStack();
+    txProbe(c, doc);
+    size_t stack = stackUsed();
+
+    stream.out = 0;
+    unsigned long iterations = 0;
+    unsigned long t0 = micros();
+    unsigned long elapsed;
+    do {
+        txOnce(c, doc);
+        iterations++;
+        elapsed = micros() - t0;
+    } while (elapsed < BENCH_MIN_MS * 1000UL);
+
+    report(c.name, iterations, stream.out, elapsed, stack);
+}
+
+/* ===== ENTRÉE ===== */
+
+static void runAll() {
+    emit("bench_env " BENCH_ENV);
+    for (const RxCase &c : RX_CASES) benchRx(c);
+    for (const TxCase &c : TX_CASES) benchTx(c);
+    emit("bench_done");
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+void setup() {
+    Serial.begin(115200);
+    runAll();
+}
+
+void loop() {
+}
+#else
+int main() {
+    runAll();
+    return 0;
+}
+#endif
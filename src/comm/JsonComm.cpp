@@ -1,4 +1,5 @@
 #include "JsonComm.h"
+#include "../trace/InputTrace.h"
 
 #ifndef DEBUG_PRINTLN
 // Keep existing DEBUG_PRINT macros compatibility if defined elsewhere.
@@ -26,6 +27,7 @@ bool JsonComm::receiveCommand(StaticJsonDocument<256> &outDoc) {
     while (serial.available() > 0) {
         int c = serial.read();
         if (c < 0) break;
+        INPUT_TRACE_RX((uint8_t)c);
 
         // Accept CR but treat only LF as terminator
         if (c == '\r') continue;
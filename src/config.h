@@ -13,9 +13,95 @@
   #define DEBUG_PRINT(x)  ((void)0)
 #endif
 
+// Latency trace badge -> relay ("trace" field in badge/open_door events + p50/p99 in stats)
+// Comment out to drop the instrumentation
+#define LATENCY_TRACE_ENABLE
+
+// Low-power idle : le MCU dort entre deux scans après une période sans activité
+// Comment out to keep full-speed polling 24/7
+#define POWER_IDLE_ENABLE
+#define POWER_ACTIVE_HOLD_MS 3000UL   // reste à pleine vitesse après la dernière activité
+#define POWER_IDLE_POLL_MS 50UL       // période de scan clavier/RFID en idle
+
+// Watchdog + délais max entre deux check-in de chaque sous-système (ms) :
+// au-dessus des blocages connus de loop() (UIFeedback <= 400 ms, auto-test
+// RFID ~0,9 s en session admin), sous le timeout du watchdog (2 s)
+#define HEALTH_DEADLINE_RFID_MS 1000UL
+#define HEALTH_DEADLINE_RELAY_MS 1000UL
+#define HEALTH_DEADLINE_SERIAL_MS 1000UL
+
+// RFID en polling : cadence adaptative et suivi de retrait de carte (ms)
+#define RFID_POLL_FAST_MS 20
+#define RFID_POLL_SLOW_MS 150
+#define RFID_ACTIVITY_WINDOW_MS 5000UL
+#define RFID_REMOVAL_DEBOUNCE_MS 300UL
+
+// Lecteurs RFID sur bus SPI partagé (un SS chacun), ordonnancés en round-robin
+#define RFID_READER_COUNT 1
+#define RFID_MAX_READERS 4
+#define RFID_SLICE_BUDGET_US 50000UL  // au-delà, le poll d'un lecteur compte comme "lent"
+#define RFID_SLOW_STRIKES 3
+#define RFID_REPROBE_MS 5000UL
+
+// Profil lecteur par défaut (0 rapide, 1 équilibré, 2 portée) et durée d'auto-test par profil
+#define RFID_PROFILE_DEFAULT 1
+#define RFID_SELFTEST_MS 300UL
+
+// RFID en mode IRQ : période de ré-armement du REQA (ms), nb max de lecteurs sur IRQ
+#define RFID_IRQ_REARM_MS 50UL
+#define RFID_MAX_IRQ_READERS 2
+#define RFID_BENCH_MS 400UL           // durée de mesure par mode (rfid_bench)
+
+// Pics mémoire (commande "mem") : RAM libre peinte au boot, relue depuis housekeeping
+// toutes les MEM_SCAN_EVERY_LOOPS boucles (et à chaque "mem")
+#define MEM_PAINT 0xA5
+#define MEM_PAINT_GUARD 32            // octets sous le SP de setup() laissés intacts
+#define MEM_SCAN_EVERY_LOOPS 64
+// Relecture à chaque fin d'étape : pic de pile attribué à son étape, mais
+// ~10-15 ms par boucle sur le chemin badge. Diagnostic seulement
+// #define MEM_WATCH_STAGE_SCAN
+
 // EEPROM / system defaults
 #define EEPROM_MAGIC 0xA5A5
-#define EEPROM_VERSION 1
+// Version du layout, incrémentée à chaque zone ajoutée (+ une étape dans
+// EEPROMStore::MIGRATIONS) : v2 enregistrement santé, v3 profil lecteur,
+// v4 plages horaires, v5 journal d'accès, v6 rôles des badges, v7 config,
+// v8 verrouillage PIN
+#define EEPROM_VERSION 8
+
+// Clavier 4x4 scanné sous IRQ (Timer0 COMPB, ~1 kHz, une ligne par tick) :
+// touche validée après N balayages complets identiques (4 lignes x N ~ ms),
+// appuis horodatés en file (puissance de 2, une case reste vide)
+#define KEYPAD_DEBOUNCE_SCANS 4
+#define KEYPAD_EVENT_QUEUE 16
+
+// Longueur max d'une commande (keypad ou champ "cmd" série), sans '\0'
+#define CMD_MAX_LEN 16
+
+// Longueur max du champ "id" d'une requête série, repris dans ses réponses
+#define REQ_ID_MAX_LEN 15
+
+// Cache LRU des dernières recherches UID (entrées de 7 octets en RAM)
+#define UID_CACHE_SIZE 8
+
+// Plages horaires : nb de modèles hebdomadaires partagés (42 octets EEPROM + 42 RAM chacun)
+// Horloge non synchronisée : 0 = badge avec modèle refusé (fail-secure), 1 = autorisé
+#define SCHEDULE_TEMPLATES 4
+#define SCHEDULE_UNSYNCED_ALLOW 0
+
+// Journal d'accès en anneau EEPROM (10 octets / enregistrement), écritures différées
+#define AUDIT_RECORDS 44
+#define AUDIT_QUEUE_SIZE 4            // décisions en attente d'écriture (RAM)
+#define AUDIT_CHUNK 6                 // enregistrements par réponse "audit"
+
+// Session admin (après PIN ou badge admin) : délai max avant la commande
+#define ADMIN_SESSION_TIMEOUT_MS 15000UL
+
+// Verrouillage PIN par source (clavier / série), fenêtres exponentielles :
+// base, 2x base, 4x base... plafonnée. Essais et base modifiables en série
+#define LOCKOUT_MAX_ATTEMPTS 5
+#define LOCKOUT_DEFAULT_SEC 30
+#define LOCKOUT_MAX_SEC 3600UL
 
 // Admin PIN defaults
 #define DEFAULT_ADMIN_PIN "123"
@@ -23,4 +109,10 @@
 // Relay default open time (ms)
 #define RELAY_DEFAULT_OPEN_TIME 5000
 
+// Banque de relais (une sortie par porte) : nb de portes câblées, intervalle
+// minimal relais fermé avant réouverture (ms)
+#define RELAY_COUNT 1
+#define RELAY_MAX_CHANNELS 4
+#define RELAY_MIN_OFF_MS 500UL
+
 #endif // CONFIG_H
\ No newline at end of file
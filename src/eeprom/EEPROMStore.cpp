@@ -5,67 +5,160 @@
 #define DEBUG_PRINT(x) Serial.print(x)
 #endif
 
-EEPROMStore::EEPROMStore() {}
+EEPROMStore::EEPROMStore()
+    : cacheCount(0),
+      cacheHits(0),
+      cacheMisses(0),
+      config(defaultConfig())
+{
+}
+
+const EEPROMStore::MigrationStep EEPROMStore::MIGRATIONS[] = {
+    &EEPROMStore::migrateV1toV2,
+    &EEPROMStore::migrateV2toV3,
+    &EEPROMStore::migrateV3toV4,
+    &EEPROMStore::migrateV4toV5,
+    &EEPROMStore::migrateV5toV6,
+    &EEPROMStore::migrateV6toV7,
+    &EEPROMStore::migrateV7toV8,
+};
 
 void EEPROMStore::begin() {
     // Validate header; if invalid, initialize defaults
     uint16_t magic = readU16(OFF_MAGIC);
     uint16_t version = readU16(OFF_VERSION);
+    uint16_t storedCrc = readU16(eepromSize() - 2);
+    uint16_t crc = computeCRC16(OFF_BADGES + badgeAreaSize());
+    bool crcOk = storedCrc == crc;
 
-    if (magic != EEPROM_MAGIC || version != EEPROM_VERSION) {
-        DEBUG_PRINTLN(F("[EEPROM] Invalid header, initializing defaults"));
-        writeU16(OFF_MAGIC, EEPROM_MAGIC);
-        writeU16(OFF_VERSION, EEPROM_VERSION);
-
-        // admin PIN (8 bytes)
-        char pinBuf[8];
-        memset(pinBuf, 0, sizeof(pinBuf));
-        strncpy(pinBuf, DEFAULT_ADMIN_PIN, sizeof(pinBuf) - 1);
-        writeBlock(OFF_ADMINPIN, (const uint8_t*)pinBuf, sizeof(pinBuf));
-
-        writeU16(OFF_BADGE_COUNT, 0);
-
-        // zero badge area
-        uint16_t badgesArea = badgeAreaSize();
-        uint8_t zeros[32];
-        memset(zeros, 0, sizeof(zeros));
-        uint16_t remaining = badgesArea;
-        uint16_t addr = OFF_BADGES;
-        while (remaining) {
-            uint16_t chunk = remaining > sizeof(zeros) ? sizeof(zeros) : remaining;
-            writeBlock(addr, zeros, chunk);
-            addr += chunk;
-            remaining -= chunk;
+    if (!crcOk && magic == EEPROM_MAGIC && version > 1) {
+        // power cut between a migration step's version write and its CRC
+        // write, or between the two CRC bytes (low byte written first):
+        // the step is complete, only the CRC is stale
+        uint16_t prevCrc = computeCRC16(OFF_BADGES + badgeAreaSize(), version - 1);
+        if (storedCrc == prevCrc || storedCrc == ((prevCrc & 0xFF00) | (crc & 0x00FF))) {
+            DEBUG_PRINTLN(F("[EEPROM] Interrupted migration, CRC rewritten"));
+            updateCRC();
+            crcOk = true;
         }
+    }
 
-        // write CRC at end
-        uint16_t crc = computeCRC16(OFF_BADGES + badgeAreaSize());
-        writeU16(eepromSize() - 2, crc);
+    if (magic != EEPROM_MAGIC || version == 0) {
+        DEBUG_PRINTLN(F("[EEPROM] Invalid header, initializing defaults"));
+        reset();
+        initAreas(1);
+    } else if (!crcOk) {
+        // core format is the same in every version: the CRC is checked first
+        DEBUG_PRINTLN(F("[EEPROM] CRC mismatch, performing reset"));
+        reset();
+        initAreas(version);
+    } else if (version < EEPROM_VERSION) {
+        migrate(version);
+    } else if (version > EEPROM_VERSION) {
+        // written by a newer firmware: keep badges and PIN, rebuild the rest as from v1
+        DEBUG_PRINTLN(F("[EEPROM] Newer layout, rebuilding extension areas"));
+        migrate(1);
     } else {
-        // verify crc
-        uint16_t storedCrc = readU16(eepromSize() - 2);
-        uint16_t crc = computeCRC16(OFF_BADGES + badgeAreaSize());
-        if (storedCrc != crc) {
-            DEBUG_PRINTLN(F("[EEPROM] CRC mismatch, performing reset"));
-            reset();
-        } else {
-            DEBUG_PRINTLN(F("[EEPROM] Header ok"));
-        }
+        DEBUG_PRINTLN(F("[EEPROM] Header ok"));
     }
+
+    loadConfig();
 }
 
-String EEPROMStore::readAdminPIN() {
-    char pinBuf[8];
-    memset(pinBuf, 0, sizeof(pinBuf));
-    readBlock(OFF_ADMINPIN, (uint8_t*)pinBuf, sizeof(pinBuf));
-    return String(pinBuf);
+void EEPROMStore::migrate(uint16_t from) {
+    static_assert(sizeof(MIGRATIONS) / sizeof(MIGRATIONS[0]) == EEPROM_VERSION - 1,
+                  "one migration step per EEPROM_VERSION bump");
+
+    for (uint16_t v = from; v < EEPROM_VERSION; v++) {
+        DEBUG_PRINT(F("[EEPROM] Migration v"));
+        DEBUG_PRINTLN(v);
+        MigrationStep step = MIGRATIONS[v - 1];
+        (this->*step)();
+        // step done: a power cut from here on resumes at the next step
+        // (before updateCRC(), begin() accepts the CRC of version v)
+        writeU16(OFF_VERSION, v + 1);
+        updateCRC();
+    }
+}
+
+// Areas added after `from`, header already at EEPROM_VERSION (no version writes)
+void EEPROMStore::initAreas(uint16_t from) {
+    for (uint16_t v = from; v < EEPROM_VERSION; v++) {
+        MigrationStep step = MIGRATIONS[v - 1];
+        (this->*step)();
+    }
+}
+
+/* ----- migration steps: each one only initialises the area its version added ----- */
+
+void EEPROMStore::migrateV1toV2() {
+    uint8_t zeros[HEALTH_SIZE];
+    memset(zeros, 0, sizeof(zeros));
+    writeBlock(offHealth(), zeros, HEALTH_SIZE);
+}
+
+void EEPROMStore::migrateV2toV3() {
+    EEPROM.update(offLegacyProfile(), RFID_PROFILE_DEFAULT);
+    EEPROM.update(offLegacyProfile() + 1, (uint8_t)~RFID_PROFILE_DEFAULT);
+}
+
+void EEPROMStore::migrateV3toV4() {
+    // every slot 24/7, templates empty
+    for (uint16_t i = 0; i < MAX_BADGES + SCHEDULE_TEMPLATES * SCHEDULE_BITMAP_SIZE; i++) {
+        EEPROM.update(offBadgeSchedules() + i, 0);
+    }
+}
+
+void EEPROMStore::migrateV4toV5() {
+    // blank ring: no byte pattern left there passes a record check
+    for (uint16_t i = 0; i < (uint16_t)AUDIT_RECORDS * AUDIT_RECORD_SIZE; i++) {
+        EEPROM.update(auditLogOffset() + i, 0xFF);
+    }
+}
+
+void EEPROMStore::migrateV5toV6() {
+    // existing badges are plain users; the array takes over the tail of the
+    // v5 ring (48 -> 44 records)
+    uint16_t count = getBadgeCount();
+    for (uint16_t i = 0; i < MAX_BADGES; i++) {
+        EEPROM.update(offBadgeRoles() + i, i < count ? ROLE_USER : 0);
+    }
+}
+
+void EEPROMStore::migrateV6toV7() {
+    // v3 reader profile (value + inverted copy) moves into the config section
+    config = defaultConfig();
+    uint8_t v = EEPROM.read(offLegacyProfile());
+    uint8_t inv = EEPROM.read(offLegacyProfile() + 1);
+    if ((uint8_t)~v == inv) config.readerProfile = v;
+    storeConfig();
+}
+
+void EEPROMStore::migrateV7toV8() {
+    // start unlocked; "lock until reboot" (lockoutSec 0) no longer exists
+    for (uint8_t s = 0; s < LOCKOUT_SOURCES; s++) {
+        writeLockout(s, 0, 0);
+    }
+    loadConfig();
+    if (config.lockoutSec == 0) {
+        config.lockoutSec = LOCKOUT_DEFAULT_SEC;
+        storeConfig();
+    }
+}
+
+void EEPROMStore::readAdminPIN(char *out, size_t outSize) {
+    if (!out || outSize == 0) return;
+    size_t n = outSize - 1 < 8 ? outSize - 1 : 8;
+    readBlock(OFF_ADMINPIN, (uint8_t*)out, n);
+    out[n] = '\0';
 }
 
-bool EEPROMStore::writeAdminPIN(const String &pin) {
-    if (pin.length() == 0 || pin.length() >= 8) return false;
+bool EEPROMStore::writeAdminPIN(const char *pin) {
+    size_t len = pin ? strlen(pin) : 0;
+    if (len == 0 || len >= 8) return false;
     char pinBuf[8];
     memset(pinBuf, 0, sizeof(pinBuf));
-    pin.toCharArray(pinBuf, sizeof(pinBuf));
+    memcpy(pinBuf, pin, len);
     writeBlock(OFF_ADMINPIN, (const uint8_t*)pinBuf, sizeof(pinBuf));
     // update crc
     uint16_t crc = computeCRC16(OFF_BADGES + badgeAreaSize());
@@ -84,8 +177,11 @@ bool EEPROMStore::addBadge(const uint8_t *uid) {
     // check exists
     if (badgeExists(uid)) return false;
 
+    cacheClear();
     uint16_t writeAddr = OFF_BADGES + (count * UID_SIZE);
     writeBlock(writeAddr, uid, UID_SIZE);
+    EEPROM.update(offBadgeSchedules() + count, 0); // 24/7 by default
+    EEPROM.update(offBadgeRoles() + count, ROLE_USER);
     writeU16(OFF_BADGE_COUNT, count + 1);
     // update crc
     uint16_t crc = computeCRC16(OFF_BADGES + badgeAreaSize());
@@ -100,23 +196,22 @@ bool EEPROMStore::removeBadge(const uint8_t *uid) {
     if (count == 0) return false;
 
     // find index
-    int found = -1;
-    for (uint16_t i = 0; i < count; i++) {
-        uint8_t buf[UID_SIZE];
-        readBlock(OFF_BADGES + i * UID_SIZE, buf, UID_SIZE);
-        if (memcmp(buf, uid, UID_SIZE) == 0) {
-            found = i;
-            break;
-        }
-    }
+    int found = findBadge(uid);
     if (found == -1) return false;
 
-    // shift badges down
+    // slots shift below: every cached index may be stale
+    cacheClear();
+
+    // shift badges (and their schedule index / roles) down
     for (uint16_t i = found; i < count - 1; i++) {
         uint8_t buf[UID_SIZE];
         readBlock(OFF_BADGES + (i + 1) * UID_SIZE, buf, UID_SIZE);
         writeBlock(OFF_BADGES + i * UID_SIZE, buf, UID_SIZE);
+        EEPROM.update(offBadgeSchedules() + i, EEPROM.read(offBadgeSchedules() + i + 1));
+        EEPROM.update(offBadgeRoles() + i, EEPROM.read(offBadgeRoles() + i + 1));
     }
+    EEPROM.update(offBadgeSchedules() + count - 1, 0);
+    EEPROM.update(offBadgeRoles() + count - 1, 0);
     // zero last slot
     uint8_t zero[UID_SIZE];
     memset(zero, 0, UID_SIZE);
@@ -131,16 +226,30 @@ bool EEPROMStore::removeBadge(const uint8_t *uid) {
 }
 
 bool EEPROMStore::badgeExists(const uint8_t *uid) {
-    if (!uid) return false;
-    uint16_t count = getBadgeCount();
-    for (uint16_t i = 0; i < count; i++) {
-        uint8_t buf[UID_SIZE];
-        readBlock(OFF_BADGES + i * UID_SIZE, buf, UID_SIZE);
-        if (memcmp(buf, uid, UID_SIZE) == 0) {
-            return true;
+    return findBadge(uid) >= 0;
+}
+
+int16_t EEPROMStore::findBadge(const uint8_t *uid) {
+    if (!uid) return -1;
+
+    for (uint8_t i = 0; i < cacheCount; i++) {
+        if (memcmp(cache[i].uid, uid, UID_SIZE) == 0) {
+            int16_t slot = cache[i].slot;
+            // move to front (MRU)
+            if (i > 0) {
+                UidCacheEntry hit = cache[i];
+                memmove(&cache[1], &cache[0], i * sizeof(UidCacheEntry));
+                cache[0] = hit;
+            }
+            cacheHits++;
+            return slot;
         }
     }
-    return false;
+
+    cacheMisses++;
+    int16_t slot = scanSlot(uid);
+    cachePut(uid, slot);
+    return slot;
 }
 
 uint16_t EEPROMStore::getBadgeCount() {
@@ -150,6 +259,7 @@ uint16_t EEPROMStore::getBadgeCount() {
 }
 
 void EEPROMStore::reset() {
+    cacheClear();
     // Reset header and clear badges
     writeU16(OFF_MAGIC, EEPROM_MAGIC);
     writeU16(OFF_VERSION, EEPROM_VERSION);
@@ -170,12 +280,200 @@ void EEPROMStore::reset() {
         addr += chunk;
         remaining -= chunk;
     }
+    // every slot back to 24/7, templates emptied (blank EEPROM 0xFF would mean "always")
+    for (uint16_t i = 0; i < MAX_BADGES + SCHEDULE_TEMPLATES * SCHEDULE_BITMAP_SIZE; i++) {
+        EEPROM.update(offBadgeSchedules() + i, 0);
+    }
+    // no role on any slot
+    for (uint16_t i = 0; i < MAX_BADGES; i++) {
+        EEPROM.update(offBadgeRoles() + i, 0);
+    }
     // update crc
     uint16_t crc = computeCRC16(OFF_BADGES + badgeAreaSize());
     writeU16(eepromSize() - 2, crc);
     DEBUG_PRINTLN(F("[EEPROM] Reset complete"));
 }
 
+void EEPROMStore::readHealthRecord(uint8_t *buf) {
+    if (!buf) return;
+    readBlock(offHealth(), buf, HEALTH_SIZE);
+}
+
+void EEPROMStore::writeHealthRecord(const uint8_t *buf) {
+    if (!buf) return;
+    writeBlock(offHealth(), buf, HEALTH_SIZE);
+}
+
+bool EEPROMStore::readLockout(uint8_t source, uint8_t &failures, uint8_t &level) {
+    failures = 0;
+    level = 0;
+    if (source >= LOCKOUT_SOURCES) return false;
+
+    uint16_t addr = offLockout() + source * 3;
+    uint8_t f = EEPROM.read(addr);
+    uint8_t l = EEPROM.read(addr + 1);
+    if ((uint8_t)~(f + l) != EEPROM.read(addr + 2)) return false;
+
+    failures = f;
+    level = l;
+    return true;
+}
+
+void EEPROMStore::writeLockout(uint8_t source, uint8_t failures, uint8_t level) {
+    if (source >= LOCKOUT_SOURCES) return;
+    // no DEBUG output: called on every failed PIN
+    uint16_t addr = offLockout() + source * 3;
+    EEPROM.update(addr, failures);
+    EEPROM.update(addr + 1, level);
+    EEPROM.update(addr + 2, (uint8_t)~(failures + level));
+}
+
+const RuntimeConfig &EEPROMStore::getConfig() const {
+    return config;
+}
+
+void EEPROMStore::setConfig(const RuntimeConfig &cfg) {
+    config = cfg;
+    storeConfig();
+    DEBUG_PRINTLN(F("[EEPROM] Config updated"));
+}
+
+RuntimeConfig EEPROMStore::defaultConfig() {
+    RuntimeConfig cfg;
+    cfg.relayOpenMs = RELAY_DEFAULT_OPEN_TIME;
+    cfg.maxAttempts = LOCKOUT_MAX_ATTEMPTS;
+    cfg.lockoutSec = LOCKOUT_DEFAULT_SEC;
+    cfg.readerProfile = RFID_PROFILE_DEFAULT;
+    return cfg;
+}
+
+/* ----- config section : [len][fields...][checksum] ----- */
+
+// v2 fields, in order; new fields are appended (len grows, older records keep defaults)
+static const uint8_t CONFIG_FIELDS_LEN = 6;
+
+void EEPROMStore::loadConfig() {
+    config = defaultConfig();
+
+    uint8_t buf[CONFIG_AREA_SIZE];
+    readBlock(offConfig(), buf, CONFIG_AREA_SIZE);
+    uint8_t len = buf[0];
+    if (len == 0 || len > CONFIG_AREA_SIZE - 2) return;
+
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i <= len; i++) sum += buf[i];
+    if ((uint8_t)~sum != buf[len + 1]) {
+        DEBUG_PRINTLN(F("[EEPROM] Config invalid, using defaults"));
+        return;
+    }
+
+    const uint8_t *f = buf + 1;
+    if (len >= 2) config.relayOpenMs = (uint16_t)f[0] | ((uint16_t)f[1] << 8);
+    if (len >= 3) config.maxAttempts = f[2];
+    if (len >= 5) config.lockoutSec = (uint16_t)f[3] | ((uint16_t)f[4] << 8);
+    if (len >= 6) config.readerProfile = f[5];
+}
+
+void EEPROMStore::storeConfig() {
+    uint8_t buf[CONFIG_FIELDS_LEN + 2];
+    buf[0] = CONFIG_FIELDS_LEN;
+    buf[1] = config.relayOpenMs & 0xFF;
+    buf[2] = config.relayOpenMs >> 8;
+    buf[3] = config.maxAttempts;
+    buf[4] = config.lockoutSec & 0xFF;
+    buf[5] = config.lockoutSec >> 8;
+    buf[6] = config.readerProfile;
+
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i <= CONFIG_FIELDS_LEN; i++) sum += buf[i];
+    buf[CONFIG_FIELDS_LEN + 1] = ~sum;
+
+    writeBlock(offConfig(), buf, sizeof(buf));
+}
+
+uint8_t EEPROMStore::getBadgeSchedule(int16_t slot) {
+    if (slot < 0 || slot >= (int16_t)MAX_BADGES) return 0;
+    return EEPROM.read(offBadgeSchedules() + slot);
+}
+
+bool EEPROMStore::setBadgeSchedule(uint16_t slot, uint8_t templateIndex) {
+    if (slot >= getBadgeCount() || templateIndex > SCHEDULE_TEMPLATES) return false;
+    EEPROM.update(offBadgeSchedules() + slot, templateIndex);
+    DEBUG_PRINTLN(F("[EEPROM] Badge schedule updated"));
+    return true;
+}
+
+void EEPROMStore::readScheduleTemplate(uint8_t index, uint8_t *bitmap) {
+    if (!bitmap || index == 0 || index > SCHEDULE_TEMPLATES) return;
+    readBlock(offScheduleTemplates() + (index - 1) * SCHEDULE_BITMAP_SIZE, bitmap, SCHEDULE_BITMAP_SIZE);
+}
+
+void EEPROMStore::writeScheduleTemplate(uint8_t index, const uint8_t *bitmap) {
+    if (!bitmap || index == 0 || index > SCHEDULE_TEMPLATES) return;
+    writeBlock(offScheduleTemplates() + (index - 1) * SCHEDULE_BITMAP_SIZE, bitmap, SCHEDULE_BITMAP_SIZE);
+    DEBUG_PRINTLN(F("[EEPROM] Schedule template updated"));
+}
+
+uint8_t EEPROMStore::getBadgeRoles(int16_t slot) {
+    if (slot < 0 || slot >= (int16_t)MAX_BADGES) return 0;
+    uint8_t roles = EEPROM.read(offBadgeRoles() + slot);
+    return (roles & ~ROLE_MASK) ? 0 : roles; // unknown bits: fail-secure, no role
+}
+
+bool EEPROMStore::setBadgeRoles(uint16_t slot, uint8_t roles) {
+    if (slot >= getBadgeCount() || (roles & ~ROLE_MASK)) return false;
+    EEPROM.update(offBadgeRoles() + slot, roles);
+    DEBUG_PRINTLN(F("[EEPROM] Badge roles updated"));
+    return true;
+}
+
+bool EEPROMStore::lookupBadge(const uint8_t *uid, BadgeInfo &info) {
+    info.slot = findBadge(uid);
+    if (info.slot < 0) {
+        info.roles = 0;
+        info.schedule = 0;
+        return false;
+    }
+    info.roles = getBadgeRoles(info.slot);
+    info.schedule = getBadgeSchedule(info.slot);
+    return true;
+}
+
+uint32_t EEPROMStore::getCacheHits() const {
+    return cacheHits;
+}
+
+uint32_t EEPROMStore::getCacheMisses() const {
+    return cacheMisses;
+}
+
+/* ----- UID cache ----- */
+
+int16_t EEPROMStore::scanSlot(const uint8_t *uid) {
+    uint16_t count = getBadgeCount();
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t buf[UID_SIZE];
+        readBlock(OFF_BADGES + i * UID_SIZE, buf, UID_SIZE);
+        if (memcmp(buf, uid, UID_SIZE) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void EEPROMStore::cachePut(const uint8_t *uid, int16_t slot) {
+    // insert at front, evict least recently used
+    uint8_t n = cacheCount < UID_CACHE_SIZE ? cacheCount : UID_CACHE_SIZE - 1;
+    memmove(&cache[1], &cache[0], n * sizeof(UidCacheEntry));
+    memcpy(cache[0].uid, uid, UID_SIZE);
+    cache[0].slot = slot;
+    if (cacheCount < UID_CACHE_SIZE) cacheCount++;
+}
+
+void EEPROMStore::cacheClear() {
+    cacheCount = 0;
+}
+
 /* ----- low level helpers ----- */
 
 uint16_t EEPROMStore::readU16(uint16_t addr) {
@@ -201,13 +499,24 @@ void EEPROMStore::readBlock(uint16_t addr, uint8_t *data, uint16_t len) {
     }
 }
 
+void EEPROMStore::updateCRC() {
+    writeU16(eepromSize() - 2, computeCRC16(OFF_BADGES + badgeAreaSize()));
+}
+
 // Simple CRC16-CCITT implementation over EEPROM area [0, uptoAddr)
 uint16_t EEPROMStore::computeCRC16(uint16_t uptoAddr) {
+    return computeCRC16(uptoAddr, readU16(OFF_VERSION));
+}
+
+// Same, as if the header held `version` instead of the stored one
+uint16_t EEPROMStore::computeCRC16(uint16_t uptoAddr, uint16_t version) {
     uint16_t crc = 0xFFFF;
     uint16_t maxAddr = uptoAddr;
     if (maxAddr > eepromSize() - 2) maxAddr = eepromSize() - 2;
     for (uint16_t a = 0; a < maxAddr; a++) {
         uint8_t b = EEPROM.read(a);
+        if (a == OFF_VERSION) b = version & 0xFF;
+        else if (a == OFF_VERSION + 1) b = (version >> 8) & 0xFF;
         crc ^= ((uint16_t)b << 8);
         for (uint8_t i = 0; i < 8; i++) {
             if (crc & 0x8000) crc = (crc << 1) ^ 0x1021;
@@ -221,6 +530,38 @@ uint16_t EEPROMStore::badgeAreaSize() const {
     return (uint16_t)UID_SIZE * (uint16_t)MAX_BADGES;
 }
 
+uint16_t EEPROMStore::offHealth() const {
+    return OFF_BADGES + badgeAreaSize();
+}
+
+uint16_t EEPROMStore::offLegacyProfile() const {
+    return offHealth() + HEALTH_SIZE;
+}
+
+uint16_t EEPROMStore::offBadgeSchedules() const {
+    return offLegacyProfile() + 2;
+}
+
+uint16_t EEPROMStore::offScheduleTemplates() const {
+    return offBadgeSchedules() + MAX_BADGES;
+}
+
+uint16_t EEPROMStore::auditLogOffset() const {
+    return offScheduleTemplates() + SCHEDULE_TEMPLATES * SCHEDULE_BITMAP_SIZE;
+}
+
+uint16_t EEPROMStore::offBadgeRoles() const {
+    return auditLogOffset() + (uint16_t)AUDIT_RECORDS * AUDIT_RECORD_SIZE;
+}
+
+uint16_t EEPROMStore::offConfig() const {
+    return offBadgeRoles() + MAX_BADGES;
+}
+
+uint16_t EEPROMStore::offLockout() const {
+    return offConfig() + CONFIG_AREA_SIZE;
+}
+
 uint16_t EEPROMStore::eepromSize() const {
     // Use EEPROM.length() to get actual device EEPROM size at runtime
     return (uint16_t)EEPROM.length();
@@ -12,36 +12,136 @@
   - UID_SIZE matches RFIDModule::UID_SIZE (5).
   - API kept compatible with existing main.cpp usages:
       begin()
-      readAdminPIN() -> String
-      writeAdminPIN(const String&)
+      readAdminPIN(char *out, size_t outSize)
+      writeAdminPIN(const char *pin)
       addBadge(const uint8_t *uid)
       removeBadge(const uint8_t *uid)
       badgeExists(const uint8_t *uid)
       getBadgeCount()
       reset()
+  - Small LRU cache of recent UID -> slot lookups (hits and misses) in RAM,
+    cleared by addBadge/removeBadge/reset: repeat swipes skip the EEPROM scan.
+  - Health record (HEALTH_SIZE bytes) right after the badge area, outside the CRC:
+    diagnostic data written by HealthSupervisor, survives reset().
+  - 2 bytes after the health record: v3 reader profile (value + inverted copy),
+    folded into the config section by the v6 -> v7 migration, now unused.
+  - Per-badge schedule template index (1 byte per slot, 0/0xFF = 24/7), then
+    SCHEDULE_TEMPLATES weekly bitmaps of SCHEDULE_BITMAP_SIZE bytes.
+  - Audit log ring (AUDIT_RECORDS x AUDIT_RECORD_SIZE, owned by AuditLog)
+    after the templates; survives reset().
+  - Per-badge role bits (1 byte per slot) after the ring.
+  - Runtime config (CONFIG_AREA_SIZE bytes) after the roles: length, typed
+    fields, checksum. Read once into RAM by begin(); fields missing from a
+    shorter record take their default. Survives reset().
+  - Lockout state per auth source after the config: failures, level, check
+    byte. Survives reset() and reboots (power-cycling must not lift a lockout).
+  - Versioning: each area is appended after the previous ones and bumps
+    EEPROM_VERSION, so the core (header, badges, CRC) and every older area
+    keep their offsets. A lower version is migrated in place at boot by
+    MIGRATIONS, one step per version: the step initialises the area that
+    version added (never guesses from the bytes found there), is
+    idempotent and is followed by a version write.
+    The CRC covers the version: a power cut between the version write and
+    the CRC write (or between the two CRC bytes) leaves the CRC of the
+    previous version (or half of it), accepted by begin().
 */
 
+// Settings changeable at runtime (serial), persisted in the config section
+struct RuntimeConfig {
+    uint16_t relayOpenMs;
+    uint8_t maxAttempts;      // failed PINs before lockout
+    uint16_t lockoutSec;      // first lockout window, doubled on each repeat
+    uint8_t readerProfile;
+};
+
+// Everything known about a badge, from one index lookup
+struct BadgeInfo {
+    int16_t slot;       // -1 if unknown
+    uint8_t roles;      // EEPROMStore::ROLE_* bits
+    uint8_t schedule;   // template index, 0 = 24/7
+};
+
 class EEPROMStore {
 public:
     static const uint8_t UID_SIZE = 5;
     static const uint16_t MAX_BADGES = 50; // safe default; adapt to EEPROM size
+    static const uint8_t HEALTH_SIZE = 12;
+    static const uint8_t SCHEDULE_BITMAP_SIZE = 42; // 7 jours x 48 créneaux de 30 min
+    static const uint8_t AUDIT_RECORD_SIZE = 10;
+
+    // Role bits (a badge may combine several)
+    static const uint8_t ROLE_USER = 0x01;        // door, subject to its schedule
+    static const uint8_t ROLE_SUPERVISOR = 0x02;  // door, schedule bypassed
+    static const uint8_t ROLE_ADMIN = 0x04;       // admin card: replaces the PIN
+    static const uint8_t ROLE_MAINTENANCE = 0x08; // door even while the clock is unsynced
+    static const uint8_t ROLE_MASK = 0x0F;
+
+    static const uint8_t CONFIG_AREA_SIZE = 16;
+    static const uint8_t LOCKOUT_SOURCES = 2;
 
     EEPROMStore();
 
     void begin();
 
-    String readAdminPIN();
-    bool writeAdminPIN(const String &pin);
+    void readAdminPIN(char *out, size_t outSize); // toujours terminé par '\0'
+    bool writeAdminPIN(const char *pin);
 
     bool addBadge(const uint8_t *uid);
     bool removeBadge(const uint8_t *uid);
     bool badgeExists(const uint8_t *uid);
+    int16_t findBadge(const uint8_t *uid);   // slot index, -1 if unknown (cached)
+    bool lookupBadge(const uint8_t *uid, BadgeInfo &info); // findBadge + per-slot bytes
 
     uint16_t getBadgeCount();
 
     void reset();
 
+    // Diagnostic record (not covered by CRC), written and read back at boot
+    // by HealthSupervisor
+    void readHealthRecord(uint8_t *buf);
+    void writeHealthRecord(const uint8_t *buf);
+
+    // Runtime config: RAM copy, setConfig() writes the changed bytes only
+    const RuntimeConfig &getConfig() const;
+    void setConfig(const RuntimeConfig &cfg);
+    static RuntimeConfig defaultConfig();
+
+    // Schedule template index of a badge slot: one EEPROM read, no scan
+    uint8_t getBadgeSchedule(int16_t slot);
+    bool setBadgeSchedule(uint16_t slot, uint8_t templateIndex);
+    void readScheduleTemplate(uint8_t index, uint8_t *bitmap);   // index 1..SCHEDULE_TEMPLATES
+    void writeScheduleTemplate(uint8_t index, const uint8_t *bitmap);
+
+    uint8_t getBadgeRoles(int16_t slot);
+    bool setBadgeRoles(uint16_t slot, uint8_t roles);
+
+    // First byte of the audit ring (layout owned by AuditLog)
+    uint16_t auditLogOffset() const;
+
+    // Lockout counters of one auth source; false (zeros) if never written / invalid
+    bool readLockout(uint8_t source, uint8_t &failures, uint8_t &level);
+    void writeLockout(uint8_t source, uint8_t failures, uint8_t level);
+
+    uint32_t getCacheHits() const;
+    uint32_t getCacheMisses() const;
+
 private:
+    struct UidCacheEntry {
+        uint8_t uid[UID_SIZE];
+        int16_t slot;              // -1 = badge inconnu (résultat négatif mis en cache)
+    };
+
+    UidCacheEntry cache[UID_CACHE_SIZE]; // [0] = plus récent
+    uint8_t cacheCount;
+    uint32_t cacheHits;
+    uint32_t cacheMisses;
+
+    RuntimeConfig config;
+
+    int16_t scanSlot(const uint8_t *uid);
+    void cachePut(const uint8_t *uid, int16_t slot);
+    void cacheClear();
+
     // Layout offsets (bytes)
     static const uint16_t OFF_MAGIC = 0;         // uint16_t
     static const uint16_t OFF_VERSION = 2;       // uint16_t
@@ -56,8 +156,33 @@ private:
     void readBlock(uint16_t addr, uint8_t *data, uint16_t len);
 
     uint16_t computeCRC16(uint16_t uptoAddr); // compute crc over [0, uptoAddr)
+    uint16_t computeCRC16(uint16_t uptoAddr, uint16_t version);
+    void updateCRC();
+
+    // Migrations: MIGRATIONS[i] turns a v(i+1) layout into v(i+2)
+    typedef void (EEPROMStore::*MigrationStep)();
+    static const MigrationStep MIGRATIONS[];
+    void migrate(uint16_t from);
+    void initAreas(uint16_t from);
+    void migrateV1toV2();   // health record
+    void migrateV2toV3();   // reader profile
+    void migrateV3toV4();   // schedules + templates
+    void migrateV4toV5();   // audit ring
+    void migrateV5toV6();   // badge roles
+    void migrateV6toV7();   // config section
+    void migrateV7toV8();   // lockout state
+
+    void loadConfig();
+    void storeConfig();
 
     uint16_t badgeAreaSize() const;
+    uint16_t offHealth() const;
+    uint16_t offLegacyProfile() const;
+    uint16_t offBadgeSchedules() const;
+    uint16_t offScheduleTemplates() const;
+    uint16_t offBadgeRoles() const;
+    uint16_t offConfig() const;
+    uint16_t offLockout() const;
     uint16_t eepromSize() const;
 };
 
@@ -0,0 +1,150 @@
+/*
+  SerialFuzz — fuzzing du lien série : trame JsonComm + dispatch de main.cpp
+  - Firmware complet (setup()/loop() inchangés) sur la carte simulée
+    (src/hal/linux), horloge virtuelle, port série alimenté par l'entrée.
+  - Une entrée = octets bruts reçus sur Serial, injectés par rafales de
+    FUZZ_BURST octets avec loop() entre deux : lignes fragmentées, plusieurs
+    lignes par rafale, débordement puis vidange, CR, id manquant...
+  - Fin d'entrée : '\n' ajouté puis loop() jusqu'à consommation, pour que
+    l'entrée suivante parte d'un tampon de ligne vide. L'état applicatif
+    (FSM, verrouillages, EEPROM) persiste d'une entrée à l'autre, comme sur
+    un vrai lien : un crash se reproduit en rejouant l'entrée seule ou le
+    corpus dans l'ordre.
+
+  libFuzzer (clang, ASan + UBSan) : pio run -e native_fuzz -t fuzz
+  Rejeu / AFL / gcc (-DFUZZ_STANDALONE) :
+      program fichier|dossier...   rejoue le corpus, affiche execs/s
+      program < entrée             une entrée sur stdin (afl-fuzz)
+*/
+
+#include <Arduino.h>
+#include "../hal/linux/SimBoard.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifndef FUZZ_BURST
+#define FUZZ_BURST 48          // octets livrés entre deux tours de loop()
+#endif
+#define FUZZ_MAX_LOOPS 2000    // garde-fou par rafale (FSM bloquée en attente)
+#define FUZZ_SETTLE_LOOPS 8    // tours après vidange : commande prise par la FSM
+
+void setup();
+void loop();
+
+// Câblage du clavier défini par le firmware (main.cpp)
+extern char keys[];
+extern byte rowPins[];
+extern byte colPins[];
+
+static void runLoops() {
+    unsigned n = 0;
+    while ((sim::serialPending() > 0 || !sim::idle()) && n < FUZZ_MAX_LOOPS) {
+        loop();
+        sim::onLoop();
+        n++;
+    }
+    for (uint8_t i = 0; i < FUZZ_SETTLE_LOOPS; i++) {
+        loop();
+        sim::onLoop();
+    }
+}
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***) {
+    sim::useVirtualClock(true);
+    sim::setReplay(true);      // RX série pris dans injectSerial(), pas de pty
+    sim::setVerbose(false);
+    sim::setKeypad(keys, rowPins, colPins, SIM_KEYPAD_ROWS, SIM_KEYPAD_COLS);
+    setup();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    for (size_t off = 0; off < size; off += FUZZ_BURST) {
+        size_t n = (size - off) < FUZZ_BURST ? size - off : FUZZ_BURST;
+        sim::injectSerial(data + off, n);
+        runLoops();
+    }
+
+    static const uint8_t newline = '\n';
+    sim::injectSerial(&newline, 1);
+    runLoops();
+    return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+
+/* ===== REJEU DU CORPUS (sans libFuzzer) ===== */
+
+static unsigned long execs = 0;
+static unsigned long long inputBytes = 0;
+
+static bool runFile(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s : %s\n", path, strerror(errno));
+        return false;
+    }
+    static uint8_t buf[1 << 16];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    LLVMFuzzerTestOneInput(buf, n);
+    execs++;
+    inputBytes += n;
+    return true;
+}
+
+static bool runPath(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "%s : %s\n", path, strerror(errno));
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode)) return runFile(path);
+
+    // Ordre alphabétique : même séquence d'entrées, même état à chaque rejeu
+    struct dirent **names;
+    int count = scandir(path, &names, nullptr, alphasort);
+    if (count < 0) return false;
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        if (names[i]->d_name[0] != '.') {
+            char full[1024];
+            snprintf(full, sizeof(full), "%s/%s", path, names[i]->d_name);
+            ok = runFile(full) && ok;
+        }
+        free(names[i]);
+    }
+    free(names);
+    return ok;
+}
+
+static double nowS() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    if (argc < 2) {
+        static uint8_t buf[1 << 16];
+        size_t n = fread(buf, 1, sizeof(buf), stdin);
+        LLVMFuzzerTestOneInput(buf, n);
+        return 0;
+    }
+
+    double t0 = nowS();
+    bool ok = true;
+    for (int i = 1; i < argc; i++) ok = runPath(argv[i]) && ok;
+    double elapsed = nowS() - t0;
+    if (elapsed <= 0) elapsed = 1e-9;
+
+    printf("fuzz execs=%lu bytes=%llu execs_s=%.0f\n", execs, inputBytes, execs / elapsed);
+    return ok ? 0 : 1;
+}
+
+#endif // FUZZ_STANDALONE
@@ -0,0 +1,795 @@
+#include "SimBoard.h"
+#include "../../trace/InputTrace.h"
+
+#include <EEPROM.h>
+#include <SPI.h>
+#include <MFRC522.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+SPIClass SPI;
+
+/* ===== ÉTAT DE LA CARTE ===== */
+
+namespace {
+
+// Horloge
+bool virtualMode = false;
+unsigned long virtualUs = 0;
+struct timespec bootTs;
+bool bootSet = false;
+
+// Broches
+uint8_t pinModes[SIM_NUM_PINS];
+uint8_t latch[SIM_NUM_PINS];       // niveau écrit (sortie) / pull-up (entrée)
+uint8_t external[SIM_NUM_PINS];    // niveau imposé de l'extérieur (setInput)
+bool externalSet[SIM_NUM_PINS];
+bool verbose = true;
+
+// Interruptions externes (numéros Arduino 0..5)
+const uint8_t IRQ_COUNT = 6;
+void (*isrs[IRQ_COUNT])() = { nullptr };
+int isrModes[IRQ_COUNT] = { 0 };
+
+// Clavier : câblage fourni par setKeypad() ; sans appel, carte sans clavier
+const char *keymap = nullptr;
+const byte *rowPins = nullptr;
+const byte *colPins = nullptr;
+uint8_t keyRows = 0;
+uint8_t keyCols = 0;
+bool pressed[SIM_KEYPAD_ROWS][SIM_KEYPAD_COLS];
+unsigned long keysFreeAtMs = 0;    // fin de la dernière frappe programmée
+
+// Lecteurs RFID
+struct Reader {
+    uint8_t ssPin;
+    bool present;
+    bool halted;
+    uint8_t uid[SIM_UID_MAX];
+    uint8_t uidLen;
+};
+Reader readers[SIM_MAX_READERS];
+uint8_t readerTotal = 0;
+
+// Port série
+int ptyMaster = -1;
+int ptySlave = -1;
+char ptyPath[64] = "";
+const uint8_t RX_SIZE = 64;        // SERIAL_RX_BUFFER_SIZE du core AVR
+uint8_t rxBuf[RX_SIZE];
+uint8_t rxHead = 0;
+uint8_t rxCount = 0;
+unsigned long txDropped = 0;
+bool echoTx = false;
+char txLine[SIM_TX_LINE];
+size_t txLen = 0;
+
+// Trace : enregistrement
+FILE *recordFile = nullptr;
+uint8_t recRx[32];                 // octets RX lus dans la même ms : une seule entrée
+uint8_t recRxLen = 0;
+unsigned long recRxMs = 0;
+
+// Trace : rejeu (RX série fourni par la trace)
+bool replaying = false;
+uint8_t replayRx[SIM_RX_REPLAY];
+size_t replayHead = 0;
+size_t replayCount = 0;
+
+// Temps CPU hôte par étape LatencyTrace (depuis DETECT)
+struct StageCpu {
+    const char *name;
+    uint32_t n;
+    double sumUs;
+    double maxUs;
+};
+StageCpu stageCpu[SIM_STAGES];
+uint8_t stageTotal = 0;
+double stageStartUs = 0;
+
+// Actions différées
+enum class ActionKind : uint8_t { CARD_OFF, KEY_DOWN, KEY_UP };
+struct Action {
+    unsigned long atMs;
+    ActionKind kind;
+    uint8_t reader;
+    char key;
+};
+Action actions[SIM_MAX_ACTIONS];
+uint8_t actionCount = 0;
+
+bool schedule(const Action &a) {
+    if (actionCount >= SIM_MAX_ACTIONS) {
+        sim::log("file d'actions pleine");
+        return false;
+    }
+    actions[actionCount++] = a;
+    return true;
+}
+
+bool findKey(char key, uint8_t &r, uint8_t &c) {
+    for (uint8_t i = 0; i < keyRows * keyCols; i++) {
+        if (keymap[i] == key) {
+            r = i / keyCols;
+            c = i % keyCols;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isKeypadRow(uint8_t pin) {
+    for (uint8_t r = 0; r < keyRows; r++) {
+        if (rowPins[r] == pin) return true;
+    }
+    return false;
+}
+
+int keypadColumn(uint8_t pin) {
+    for (uint8_t c = 0; c < keyCols; c++) {
+        if (colPins[c] == pin) return c;
+    }
+    return -1;
+}
+
+// Niveau vu sur la broche : sortie, matrice clavier, niveau externe ou pull-up
+int level(uint8_t pin) {
+    if (pin >= SIM_NUM_PINS) return LOW;
+    if (pinModes[pin] == OUTPUT) return latch[pin];
+
+    int c = keypadColumn(pin);
+    if (c >= 0) {
+        for (uint8_t r = 0; r < keyRows; r++) {
+            uint8_t rp = rowPins[r];
+            if (pressed[r][c] && pinModes[rp] == OUTPUT && latch[rp] == LOW) return LOW;
+        }
+    }
+
+    if (externalSet[pin]) return external[pin];
+    return pinModes[pin] == INPUT_PULLUP || latch[pin] ? HIGH : LOW;
+}
+
+int irqOf(uint8_t pin) {
+    int n = digitalPinToInterrupt(pin);
+    return (n >= 0 && n < IRQ_COUNT) ? n : -1;
+}
+
+void fireEdge(uint8_t pin, int before, int after) {
+    int n = irqOf(pin);
+    if (n < 0 || !isrs[n] || before == after) return;
+    int m = isrModes[n];
+    if (m == CHANGE || (m == FALLING && after == LOW) || (m == RISING && after == HIGH)) {
+        isrs[n]();
+    }
+}
+
+void formatUid(const uint8_t *uid, uint8_t len, char *out) {
+    for (uint8_t i = 0; i < len; i++) sprintf(out + 2 * i, "%02X", uid[i]);
+    out[2 * len] = '\0';
+}
+
+void pullRx() {
+    if (replaying) {
+        while (rxCount < RX_SIZE && replayCount > 0) {
+            rxBuf[(rxHead + rxCount) % RX_SIZE] = replayRx[replayHead];
+            rxCount++;
+            replayHead = (replayHead + 1) % SIM_RX_REPLAY;
+            replayCount--;
+        }
+        return;
+    }
+    if (ptyMaster < 0) return;
+    while (rxCount < RX_SIZE) {
+        uint8_t b;
+        ssize_t n = ::read(ptyMaster, &b, 1);
+        if (n != 1) break;
+        rxBuf[(rxHead + rxCount) % RX_SIZE] = b;
+        rxCount++;
+    }
+}
+
+void echoByte(uint8_t b) {
+    if (b == '\r') return;
+    if (b == '\n' || txLen == SIM_TX_LINE - 1) {
+        txLine[txLen] = '\0';
+        sim::log("tx %s", txLine);
+        txLen = 0;
+        if (b == '\n') return;
+    }
+    txLine[txLen++] = (char)b;
+}
+
+void writeHex(FILE *f, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) fprintf(f, "%02X", data[i]);
+}
+
+void flushRecordedRx() {
+    if (!recordFile || recRxLen == 0) return;
+    fprintf(recordFile, "%lu rx ", recRxMs);
+    writeHex(recordFile, recRx, recRxLen);
+    fputc('\n', recordFile);
+    recRxLen = 0;
+}
+
+double threadCpuUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+} // namespace
+
+/* ===== POINTS DE TRACE (InputTrace) ===== */
+
+void inputTraceRx(uint8_t b) {
+    if (!recordFile) return;
+    unsigned long now = millis();
+    if (recRxLen == sizeof(recRx) || (recRxLen && now != recRxMs)) flushRecordedRx();
+    if (recRxLen == 0) recRxMs = now;
+    recRx[recRxLen++] = b;
+}
+
+void inputTraceUid(uint8_t ssPin, const uint8_t *uid, uint8_t len) {
+    if (!recordFile) return;
+    flushRecordedRx();
+    fprintf(recordFile, "%lu uid %u ", millis(), ssPin);
+    writeHex(recordFile, uid, len);
+    fputc('\n', recordFile);
+}
+
+void inputTraceKey(char key) {
+    if (!recordFile) return;
+    flushRecordedRx();
+    fprintf(recordFile, "%lu key %c\n", millis(), key);
+}
+
+void inputTraceStage(const char *stage, bool first) {
+    double now = threadCpuUs();
+    if (first) stageStartUs = now;
+
+    StageCpu *st = nullptr;
+    for (uint8_t i = 0; i < stageTotal; i++) {
+        if (!strcmp(stageCpu[i].name, stage)) st = &stageCpu[i];
+    }
+    if (!st) {
+        if (stageTotal >= SIM_STAGES) return;
+        st = &stageCpu[stageTotal++];
+        st->name = stage;
+    }
+
+    double us = now - stageStartUs;
+    st->n++;
+    st->sumUs += us;
+    if (us > st->maxUs) st->maxUs = us;
+}
+
+/* ===== HORLOGE ===== */
+
+unsigned long micros() {
+    if (virtualMode) return virtualUs;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if (!bootSet) {
+        bootTs = ts;
+        bootSet = true;
+    }
+    return (unsigned long)(ts.tv_sec - bootTs.tv_sec) * 1000000UL +
+           (unsigned long)((ts.tv_nsec - bootTs.tv_nsec) / 1000);
+}
+
+unsigned long millis() {
+    return micros() / 1000UL;
+}
+
+void delay(unsigned long ms) {
+    sim::advanceUs(ms * 1000UL);
+}
+
+void delayMicroseconds(unsigned int us) {
+    sim::advanceUs(us);
+}
+
+/* ===== BROCHES ===== */
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= SIM_NUM_PINS) return;
+    int before = level(pin);
+    pinModes[pin] = mode;
+    if (mode == INPUT_PULLUP) latch[pin] = HIGH;
+    fireEdge(pin, before, level(pin));
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= SIM_NUM_PINS) return;
+    uint8_t v = val ? HIGH : LOW;
+    if (latch[pin] == v) return;
+    latch[pin] = v;
+    if (verbose && pinModes[pin] == OUTPUT && !isKeypadRow(pin)) {
+        sim::log("pin %u %s", pin, v ? "HIGH" : "LOW");
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return level(pin);
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+    if (verbose) sim::log("tone pin %u %u Hz %lu ms", pin, frequency, duration);
+}
+
+void noTone(uint8_t pin) {
+    if (verbose) sim::log("noTone pin %u", pin);
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode) {
+    if (interruptNum >= IRQ_COUNT) return;
+    isrs[interruptNum] = isr;
+    isrModes[interruptNum] = mode;
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+    if (interruptNum < IRQ_COUNT) isrs[interruptNum] = nullptr;
+}
+
+/* ===== PRINT ===== */
+
+size_t Print::write(const uint8_t *buf, size_t n) {
+    size_t done = 0;
+    while (done < n && write(buf[done])) done++;
+    return done;
+}
+
+size_t Print::print(long v, int base) {
+    if (base == DEC && v < 0) {
+        size_t n = print('-');
+        return n + print((unsigned long)-v, base);
+    }
+    return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+    char buf[8 * sizeof(long) + 1];
+    char *p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    if (base < 2) base = DEC;
+    do {
+        unsigned d = v % base;
+        *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+        v /= base;
+    } while (v);
+    return write(p);
+}
+
+size_t Print::print(double v, int digits) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+}
+
+/* ===== PORT SÉRIE (pty) ===== */
+
+void HardwareSerial::begin(unsigned long baud) {
+    if (verbose) sim::log("Serial.begin(%lu) sur %s", baud, ptyPath[0] ? ptyPath : "(aucun pty)");
+}
+
+int HardwareSerial::available() {
+    pullRx();
+    return rxCount;
+}
+
+int HardwareSerial::read() {
+    pullRx();
+    if (rxCount == 0) return -1;
+    uint8_t b = rxBuf[rxHead];
+    rxHead = (rxHead + 1) % RX_SIZE;
+    rxCount--;
+    return b;
+}
+
+int HardwareSerial::peek() {
+    pullRx();
+    return rxCount ? rxBuf[rxHead] : -1;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t n) {
+    if (echoTx) {
+        for (size_t i = 0; i < n; i++) echoByte(buf[i]);
+    }
+    if (ptyMaster < 0) return n;
+    size_t done = 0;
+    while (done < n) {
+        ssize_t w = ::write(ptyMaster, buf + done, n - done);
+        if (w > 0) {
+            done += (size_t)w;
+        } else if (w < 0 && errno == EINTR) {
+            continue;
+        } else {
+            // Personne ne lit et le tampon du pty est plein : octets perdus (comme sans hôte)
+            txDropped += n - done;
+            break;
+        }
+    }
+    return n;
+}
+
+int HardwareSerial::availableForWrite() {
+    return 63;   // SERIAL_TX_BUFFER_SIZE - 1 : jamais bloquant côté simulateur
+}
+
+/* ===== EEPROM (fichier) ===== */
+
+uint8_t EEPROMClass::read(int idx) const {
+    return (idx >= 0 && idx < SIZE) ? data[idx] : 0xFF;
+}
+
+void EEPROMClass::write(int idx, uint8_t val) {
+    if (idx < 0 || idx >= SIZE) return;
+    if (writesLeft == 0) return;          // alimentation coupée
+    if (writesLeft > 0) writesLeft--;
+    data[idx] = val;
+    writes++;
+    if (fd >= 0 && pwrite(fd, &val, 1, idx) != 1) {
+        sim::log("EEPROM : écriture fichier impossible (%s)", strerror(errno));
+    }
+}
+
+void EEPROMClass::update(int idx, uint8_t val) {
+    if (read(idx) != val) write(idx, val);
+}
+
+bool EEPROMClass::attach(const char *path) {
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+
+    ssize_t n = pread(fd, data, SIZE, 0);
+    if (n < 0) n = 0;
+    // Fichier neuf ou tronqué : le reste est effacé, puis le fichier complété
+    memset(data + n, 0xFF, SIZE - (size_t)n);
+    if (n < SIZE && pwrite(fd, data + n, SIZE - (size_t)n, n) != (ssize_t)(SIZE - n)) {
+        return false;
+    }
+    return true;
+}
+
+/* ===== MFRC522 (champ simulé) ===== */
+
+MFRC522::MFRC522(byte ssPin, byte rstPin) {
+    (void)rstPin;
+    memset(&uid, 0, sizeof(uid));
+    slot = sim::registerReader(ssPin);
+}
+
+bool MFRC522::PICC_IsNewCardPresent() {
+    // REQA : seule une carte IDLE répond
+    if (slot >= readerTotal) return false;
+    const Reader &r = readers[slot];
+    return r.present && !r.halted;
+}
+
+bool MFRC522::PICC_ReadCardSerial() {
+    if (slot >= readerTotal || !readers[slot].present) return false;
+    const Reader &r = readers[slot];
+    memcpy(uid.uidByte, r.uid, r.uidLen);
+    uid.size = r.uidLen;
+    uid.sak = 0x08;   // MIFARE Classic 1K
+    return true;
+}
+
+MFRC522::StatusCode MFRC522::PICC_WakeupA(byte *atqa, byte *atqaSize) {
+    if (slot >= readerTotal || !readers[slot].present) return STATUS_TIMEOUT;
+    readers[slot].halted = false;
+    if (atqa && atqaSize && *atqaSize >= 2) {
+        atqa[0] = 0x04;
+        atqa[1] = 0x00;
+        *atqaSize = 2;
+    }
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::PICC_HaltA() {
+    if (slot < readerTotal && readers[slot].present) readers[slot].halted = true;
+    return STATUS_OK;   // HLTA : pas de réponse = succès
+}
+
+/* ===== API DU SIMULATEUR ===== */
+
+namespace sim {
+
+void useVirtualClock(bool on) {
+    virtualMode = on;
+}
+
+bool virtualClock() {
+    return virtualMode;
+}
+
+void advanceUs(unsigned long us) {
+    if (virtualMode) {
+        virtualUs += us;
+    } else {
+        struct timespec ts = { (time_t)(us / 1000000UL), (long)(us % 1000000UL) * 1000L };
+        while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+    }
+    runDue();
+}
+
+void onLoop() {
+    advanceUs(SIM_LOOP_COST_US);
+}
+
+bool openSerial() {
+    ptyMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    if (ptyMaster < 0 || grantpt(ptyMaster) != 0 || unlockpt(ptyMaster) != 0) return false;
+
+    const char *name = ptsname(ptyMaster);
+    if (!name) return false;
+    snprintf(ptyPath, sizeof(ptyPath), "%s", name);
+
+    // Côté esclave gardé ouvert : l'hôte peut se (dé)connecter sans EIO côté maître
+    ptySlave = open(ptyPath, O_RDWR | O_NOCTTY);
+    if (ptySlave < 0) return false;
+    struct termios tio;
+    if (tcgetattr(ptySlave, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(ptySlave, TCSANOW, &tio);
+    }
+
+    fcntl(ptyMaster, F_SETFL, fcntl(ptyMaster, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+const char *serialPath() {
+    return ptyPath;
+}
+
+int serialFd() {
+    return ptyMaster;
+}
+
+uint8_t registerReader(uint8_t ssPin) {
+    if (readerTotal >= SIM_MAX_READERS) return SIM_MAX_READERS;
+    readers[readerTotal].ssPin = ssPin;
+    return readerTotal++;
+}
+
+uint8_t readerCount() {
+    return readerTotal;
+}
+
+bool presentCard(uint8_t reader, const uint8_t *uid, uint8_t len) {
+    if (reader >= readerTotal || len == 0 || len > SIM_UID_MAX) return false;
+    Reader &r = readers[reader];
+    memcpy(r.uid, uid, len);
+    r.uidLen = len;
+    r.present = true;
+    r.halted = false;
+
+    char hex[2 * SIM_UID_MAX + 1];
+    formatUid(uid, len, hex);
+    log("badge %s posé sur le lecteur %u", hex, reader);
+    return true;
+}
+
+bool removeCard(uint8_t reader) {
+    if (reader >= readerTotal) return false;
+    readers[reader].present = false;
+    readers[reader].halted = false;
+    log("badge retiré du lecteur %u", reader);
+    return true;
+}
+
+bool tapCard(uint8_t reader, const uint8_t *uid, uint8_t len) {
+    if (!presentCard(reader, uid, len)) return false;
+    Action a = {};
+    a.atMs = millis() + SIM_TAP_MS;
+    a.kind = ActionKind::CARD_OFF;
+    a.reader = reader;
+    return schedule(a);
+}
+
+bool setKeypad(const char *keys, const byte *rows, const byte *cols,
+               uint8_t rowCount, uint8_t colCount) {
+    if (!keys || !rows || !cols || rowCount > SIM_KEYPAD_ROWS || colCount > SIM_KEYPAD_COLS) {
+        log("clavier : câblage invalide (%ux%u)", rowCount, colCount);
+        return false;
+    }
+    keymap = keys;
+    rowPins = rows;
+    colPins = cols;
+    keyRows = rowCount;
+    keyCols = colCount;
+    memset(pressed, 0, sizeof(pressed));
+    return true;
+}
+
+bool pressKey(char key) {
+    uint8_t r, c;
+    if (!findKey(key, r, c)) return false;
+    pressed[r][c] = true;
+    if (verbose) log("touche %c appuyée", key);
+    return true;
+}
+
+bool releaseKey(char key) {
+    uint8_t r, c;
+    if (!findKey(key, r, c)) return false;
+    pressed[r][c] = false;
+    return true;
+}
+
+bool typeKeys(const char *keyList) {
+    unsigned long t = millis();
+    if (keysFreeAtMs > t) t = keysFreeAtMs;
+
+    for (const char *k = keyList; *k; k++) {
+        uint8_t r, c;
+        if (!findKey(*k, r, c)) {
+            log("touche inconnue : %c", *k);
+            return false;
+        }
+        Action a = {};
+        a.key = *k;
+        a.kind = ActionKind::KEY_DOWN;
+        a.atMs = t;
+        if (!schedule(a)) return false;
+        a.kind = ActionKind::KEY_UP;
+        a.atMs = t + SIM_KEY_HOLD_MS;
+        if (!schedule(a)) return false;
+        t += SIM_KEY_HOLD_MS + SIM_KEY_GAP_MS;
+    }
+    keysFreeAtMs = t;
+    runDue();
+    return true;
+}
+
+void setInput(uint8_t pin, uint8_t lvl) {
+    if (pin >= SIM_NUM_PINS) return;
+    int before = level(pin);
+    external[pin] = lvl ? HIGH : LOW;
+    externalSet[pin] = true;
+    fireEdge(pin, before, level(pin));
+}
+
+void dumpPins() {
+    for (uint8_t p = 0; p < SIM_NUM_PINS; p++) {
+        if (pinModes[p] == OUTPUT && !isKeypadRow(p)) {
+            log("pin %u OUTPUT %s", p, latch[p] ? "HIGH" : "LOW");
+        } else if (externalSet[p]) {
+            log("pin %u INPUT %s (externe)", p, external[p] ? "HIGH" : "LOW");
+        }
+    }
+    for (uint8_t i = 0; i < readerTotal; i++) {
+        char hex[2 * SIM_UID_MAX + 1] = "-";
+        if (readers[i].present) formatUid(readers[i].uid, readers[i].uidLen, hex);
+        log("lecteur %u (SS %u) : %s%s", i, readers[i].ssPin, hex, readers[i].halted ? " HALT" : "");
+    }
+    log("EEPROM : %lu écritures | série : %lu octets perdus",
+        (unsigned long)EEPROM.getWrites(), txDropped);
+}
+
+void setVerbose(bool on) {
+    verbose = on;
+}
+
+void runDue() {
+    unsigned long now = millis();
+    // Dans l'ordre d'échéance : une frappe relâche sa touche avant d'appuyer la suivante
+    while (true) {
+        int next = -1;
+        for (uint8_t i = 0; i < actionCount; i++) {
+            if ((long)(now - actions[i].atMs) < 0) continue;
+            if (next < 0 || (long)(actions[i].atMs - actions[next].atMs) < 0) next = i;
+        }
+        if (next < 0) return;
+
+        Action a = actions[next];
+        actions[next] = actions[--actionCount];
+
+        switch (a.kind) {
+            case ActionKind::CARD_OFF: removeCard(a.reader); break;
+            case ActionKind::KEY_DOWN: pressKey(a.key); break;
+            case ActionKind::KEY_UP:   releaseKey(a.key); break;
+        }
+    }
+}
+
+bool idle() {
+    return actionCount == 0;
+}
+
+bool attachEeprom(const char *path) {
+    return EEPROM.attach(path);
+}
+
+bool startRecording(const char *path) {
+    recordFile = fopen(path, "w");
+    if (!recordFile) return false;
+    // État initial : l'EEPROM (badges, config, journal) conditionne toute la suite
+    fprintf(recordFile, "# smartdoor input trace v1\n0 eeprom ");
+    writeHex(recordFile, EEPROM.image(), EEPROM.length());
+    fputc('\n', recordFile);
+    return true;
+}
+
+void stopRecording() {
+    if (!recordFile) return;
+    flushRecordedRx();
+    fclose(recordFile);
+    recordFile = nullptr;
+}
+
+void setReplay(bool on) {
+    replaying = on;
+}
+
+bool injectSerial(const uint8_t *data, size_t len) {
+    if (replayCount + len > SIM_RX_REPLAY) {
+        log("trace : tampon RX plein, %zu octets perdus", len);
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        replayRx[(replayHead + replayCount) % SIM_RX_REPLAY] = data[i];
+        replayCount++;
+    }
+    return true;
+}
+
+size_t serialPending() {
+    return replayCount + rxCount;
+}
+
+bool loadEepromHex(const char *hex) {
+    size_t n = strlen(hex) / 2;
+    if (n != EEPROM.length()) return false;
+    uint8_t img[EEPROMClass::SIZE];
+    for (size_t i = 0; i < n; i++) {
+        char byteStr[3] = { hex[2 * i], hex[2 * i + 1], '\0' };
+        img[i] = (uint8_t)strtoul(byteStr, nullptr, 16);
+    }
+    EEPROM.load(img, n);
+    return true;
+}
+
+uint8_t readerForSs(uint8_t ssPin) {
+    for (uint8_t i = 0; i < readerTotal; i++) {
+        if (readers[i].ssPin == ssPin) return i;
+    }
+    return SIM_MAX_READERS;
+}
+
+void setEcho(bool on) {
+    echoTx = on;
+}
+
+void printStageCpu() {
+    // Hors chronologie (non déterministe) : préfixe "cpu", sans horodatage
+    for (uint8_t i = 0; i < stageTotal; i++) {
+        const StageCpu &st = stageCpu[i];
+        printf("cpu %s n=%u mean_us=%.1f max_us=%.1f\n",
+               st.name, (unsigned)st.n, st.n ? st.sumUs / st.n : 0.0, st.maxUs);
+    }
+    fflush(stdout);
+}
+
+void log(const char *fmt, ...) {
+    printf("[%8lu ms] ", millis());
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    putchar('\n');
+    fflush(stdout);
+}
+
+} // namespace sim
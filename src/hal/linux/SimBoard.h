@@ -0,0 +1,103 @@
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+/*
+  SimBoard — carte Mega 2560 simulée (backend Linux de la couche matérielle)
+  - Horloge : monotone réelle, ou virtuelle (avancée par delay() et par un
+    coût fixe par tour de loop()) pour des scénarios reproductibles.
+  - Broches : mode + niveau de sortie ; une colonne du clavier lit LOW quand
+    une touche appuyée relie sa ligne, pilotée en sortie LOW par le scan.
+  - Lecteurs MFRC522 : un "champ" par lecteur (carte posée ou non),
+    lecteurs numérotés dans l'ordre de construction (rfid = 0, rfid2 = 1).
+  - Port série 0 : côté maître d'un pty, le firmware est joignable par le
+    côté esclave comme par /dev/ttyACM0.
+  - Événements (relais, buzzer, broches) : journal texte sur stdout.
+  - Trace : enregistre les entrées consommées par le firmware (InputTrace),
+    les réinjecte au rejeu et mesure le CPU hôte par étape.
+*/
+
+#include <Arduino.h>
+
+// Taille max du clavier simulé (câblage fourni par setKeypad())
+#ifndef SIM_KEYPAD_ROWS
+#define SIM_KEYPAD_ROWS 4
+#endif
+#ifndef SIM_KEYPAD_COLS
+#define SIM_KEYPAD_COLS 4
+#endif
+
+// Durées d'une frappe simulée (ms) : appui puis relâché avant la touche suivante
+#define SIM_KEY_HOLD_MS 60
+#define SIM_KEY_GAP_MS 60
+
+// Durée d'un passage de badge "tap" (ms)
+#define SIM_TAP_MS 300
+
+// Durée d'un tour de loop() (µs) : ajoutée à l'horloge virtuelle, dormie en
+// horloge réelle (sans quoi chaque porte simulée occupe un cœur de l'hôte)
+#define SIM_LOOP_COST_US 100
+
+#define SIM_MAX_READERS 4
+#define SIM_MAX_ACTIONS 64
+#define SIM_UID_MAX 10
+#define SIM_RX_REPLAY 2048   // octets série de la trace pas encore lus
+#define SIM_TX_LINE 512
+#define SIM_STAGES 8
+
+namespace sim {
+
+/* ===== Horloge ===== */
+void useVirtualClock(bool on);
+bool virtualClock();
+void advanceUs(unsigned long us);   // virtuelle : avance ; réelle : dort
+void onLoop();                      // fin d'un tour de loop()
+
+/* ===== Port série ===== */
+bool openSerial();                  // crée le pty (côté esclave : serialPath())
+const char *serialPath();
+int serialFd();
+
+/* ===== Lecteurs RFID ===== */
+uint8_t registerReader(uint8_t ssPin);
+uint8_t readerCount();
+bool presentCard(uint8_t reader, const uint8_t *uid, uint8_t len);
+bool removeCard(uint8_t reader);
+bool tapCard(uint8_t reader, const uint8_t *uid, uint8_t len);
+
+/* ===== Clavier ===== */
+// Câblage du firmware (keymap ligne par ligne), à fournir avant setup()
+bool setKeypad(const char *keys, const byte *rows, const byte *cols,
+               uint8_t rowCount, uint8_t colCount);
+bool pressKey(char key);            // appui maintenu jusqu'à releaseKey()
+bool releaseKey(char key);
+bool typeKeys(const char *keys);    // frappe complète, touche par touche
+
+/* ===== Broches ===== */
+void setInput(uint8_t pin, uint8_t level);   // niveau imposé de l'extérieur (IRQ sur front)
+void dumpPins();
+void setVerbose(bool on);
+
+/* ===== Actions différées (tap, frappes) ===== */
+void runDue();
+bool idle();                        // plus aucune action en attente
+
+/* ===== EEPROM ===== */
+bool attachEeprom(const char *path);
+
+/* ===== Trace des entrées (InputTrace) ===== */
+bool startRecording(const char *path);   // entrées consommées -> fichier
+void stopRecording();
+void setReplay(bool on);                 // RX série pris dans la trace, pty ignoré
+bool injectSerial(const uint8_t *data, size_t len);
+size_t serialPending();                  // octets injectés pas encore lus par le firmware
+bool loadEepromHex(const char *hex);
+uint8_t readerForSs(uint8_t ssPin);
+void setEcho(bool on);                   // lignes émises sur Serial -> journal "tx"
+void printStageCpu();                    // temps CPU hôte par étape LatencyTrace
+
+/* ===== Journal ===== */
+void log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+} // namespace sim
+
+#endif // SIM_BOARD_H
@@ -0,0 +1,341 @@
+/*
+  SimMain — point d'entrée du simulateur Linux
+  - Exécute setup() puis loop() du firmware sans modification.
+  - Port série : pty affiché au démarrage (--link : lien symbolique stable),
+    utilisable par la GUI, le CLI ou le hub comme une vraie porte.
+  - Pilotage : une commande par ligne sur stdin, événements sur stdout.
+
+      card <uid hex> [lecteur]   badge posé (reste jusqu'à remove)
+      tap <uid hex> [lecteur]    badge passé (retiré après SIM_TAP_MS)
+      remove [lecteur]           badge retiré
+      keys <touches>             frappe au clavier, ex. keys 123#
+      press <touche> / release <touche>
+      pin <n> <0|1>              niveau imposé sur une entrée (IRQ sur front)
+      pins                       état des sorties et des lecteurs
+      wait <ms>                  suspend la lecture des commandes (scripts)
+      verbose <0|1>
+      quit
+
+  --virtual : horloge virtuelle (aucune attente réelle), stdin lu en bloquant :
+  même scénario = même chronologie au tour de loop() près. La fin de stdin
+  termine alors la simulation une fois les actions en attente jouées.
+
+  Trace des entrées (src/trace/InputTrace.h), une entrée par ligne :
+      0 eeprom <hex>        image EEPROM au démarrage
+      <ms> rx <hex>         octets lus par JsonComm
+      <ms> uid <ss> <hex>   badge rendu par RFIDModule::poll() (lecteur = broche SS)
+      <ms> key <touche>     touche délivrée par KeypadModule::update()
+  --record : écrit la trace de la session (hôte sur le pty, stdin...).
+  --replay : horloge virtuelle, série et stdin ignorés ; octets réinjectés à
+  leur ms, badges passés (tap) et touches frappées à leur ms, lignes émises
+  sur Serial journalisées ("tx"). Fin : --settle ms après la dernière entrée,
+  puis temps CPU hôte par étape LatencyTrace (lignes "cpu", hors chronologie).
+  Comparaison à une référence : scripts/trace_replay.py
+*/
+
+#include <Arduino.h>
+#include "SimBoard.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+void setup();
+void loop();
+
+// Câblage du clavier défini par le firmware (main.cpp)
+extern char keys[];
+extern byte rowPins[];
+extern byte colPins[];
+
+namespace {
+
+const char *linkPath = nullptr;
+
+char line[256];
+size_t lineLen = 0;
+bool inputClosed = false;
+unsigned long waitUntilMs = 0;
+volatile sig_atomic_t quitRequested = false;
+
+// Rejeu
+FILE *replayFile = nullptr;
+char *entry = nullptr;             // prochaine entrée de la trace (ligne brute)
+size_t entryCap = 0;
+unsigned long entryMs = 0;
+bool entryReady = false;
+unsigned long lastEntryMs = 0;
+unsigned long settleMs = 2000;
+
+void removeLink() {
+    if (linkPath) unlink(linkPath);
+}
+
+void onSignal(int) {
+    quitRequested = true;
+}
+
+void usage(const char *prog) {
+    fprintf(stderr,
+            "usage : %s [--eeprom fichier] [--link chemin] [--virtual] [--quiet]\n"
+            "          [--record trace | --replay trace [--settle ms]] [--echo]\n", prog);
+}
+
+bool parseUid(const char *hex, uint8_t *uid, uint8_t &len) {
+    size_t n = strlen(hex);
+    if (n == 0 || n % 2 || n / 2 > SIM_UID_MAX) return false;
+    for (size_t i = 0; i < n / 2; i++) {
+        char byteStr[3] = { hex[2 * i], hex[2 * i + 1], '\0' };
+        char *end;
+        uid[i] = (uint8_t)strtoul(byteStr, &end, 16);
+        if (*end) return false;
+    }
+    len = (uint8_t)(n / 2);
+    return true;
+}
+
+uint8_t readerArg(const char *s) {
+    return s ? (uint8_t)atoi(s) : 0;
+}
+
+void execute(char *cmd) {
+    char *verb = strtok(cmd, " \t\r");
+    if (!verb || verb[0] == '#') return;
+    char *a1 = strtok(nullptr, " \t\r");
+    char *a2 = strtok(nullptr, " \t\r");
+
+    bool ok = true;
+    if (!strcmp(verb, "card") || !strcmp(verb, "tap")) {
+        uint8_t uid[SIM_UID_MAX];
+        uint8_t len = 0;
+        ok = a1 && parseUid(a1, uid, len);
+        if (ok) {
+            ok = (verb[0] == 'c') ? sim::presentCard(readerArg(a2), uid, len)
+                                  : sim::tapCard(readerArg(a2), uid, len);
+        }
+    } else if (!strcmp(verb, "remove")) {
+        ok = sim::removeCard(readerArg(a1));
+    } else if (!strcmp(verb, "keys")) {
+        ok = a1 && sim::typeKeys(a1);
+    } else if (!strcmp(verb, "press")) {
+        ok = a1 && sim::pressKey(a1[0]);
+    } else if (!strcmp(verb, "release")) {
+        ok = a1 && sim::releaseKey(a1[0]);
+    } else if (!strcmp(verb, "pin")) {
+        ok = a1 && a2;
+        if (ok) sim::setInput((uint8_t)atoi(a1), (uint8_t)atoi(a2));
+    } else if (!strcmp(verb, "pins")) {
+        sim::dumpPins();
+    } else if (!strcmp(verb, "wait")) {
+        ok = a1 != nullptr;
+        if (ok) waitUntilMs = millis() + strtoul(a1, nullptr, 10);
+    } else if (!strcmp(verb, "verbose")) {
+        sim::setVerbose(!a1 || atoi(a1) != 0);
+    } else if (!strcmp(verb, "quit")) {
+        quitRequested = true;
+    } else {
+        ok = false;
+    }
+
+    if (!ok) sim::log("commande invalide : %s", verb);
+}
+
+// Lit stdin et exécute les lignes complètes (lecture suspendue pendant "wait")
+void pollControl() {
+    while (!quitRequested) {
+        if ((long)(millis() - waitUntilMs) < 0) return;
+
+        char *nl = (char *)memchr(line, '\n', lineLen);
+        if (nl) {
+            *nl = '\0';
+            size_t used = (size_t)(nl - line) + 1;
+            execute(line);
+            memmove(line, line + used, lineLen - used);
+            lineLen -= used;
+            continue;
+        }
+
+        if (inputClosed) return;
+        if (lineLen == sizeof(line)) lineLen = 0;   // ligne trop longue : ignorée
+
+        ssize_t n = read(STDIN_FILENO, line + lineLen, sizeof(line) - lineLen);
+        if (n > 0) {
+            lineLen += (size_t)n;
+        } else if (n == 0) {
+            inputClosed = true;
+            if (lineLen && lineLen < sizeof(line)) line[lineLen++] = '\n';   // dernière ligne sans '\n'
+        } else {
+            return;   // EAGAIN : rien à lire
+        }
+    }
+}
+
+// Lit la prochaine entrée de la trace (commentaires et lignes vides sautés)
+bool nextEntry() {
+    entryReady = false;
+    while (getline(&entry, &entryCap, replayFile) > 0) {
+        if (entry[0] == '#' || entry[0] == '\n') continue;
+        char *end;
+        entryMs = strtoul(entry, &end, 10);
+        if (end == entry) continue;
+        entryReady = true;
+        return true;
+    }
+    return false;
+}
+
+void applyEntry(char *text) {
+    char *kind = strtok(text, " \t\r\n");   // horodatage
+    kind = strtok(nullptr, " \t\r\n");
+    char *a1 = strtok(nullptr, " \t\r\n");
+    char *a2 = strtok(nullptr, " \t\r\n");
+    if (!kind || !a1) return;
+
+    bool ok = true;
+    if (!strcmp(kind, "rx")) {
+        uint8_t data[64];
+        size_t n = strlen(a1) / 2;
+        ok = n <= sizeof(data);
+        for (size_t i = 0; ok && i < n; i++) {
+            char byteStr[3] = { a1[2 * i], a1[2 * i + 1], '\0' };
+            data[i] = (uint8_t)strtoul(byteStr, nullptr, 16);
+        }
+        ok = ok && sim::injectSerial(data, n);
+    } else if (!strcmp(kind, "uid")) {
+        uint8_t uid[SIM_UID_MAX];
+        uint8_t len = 0;
+        ok = a2 && parseUid(a2, uid, len) &&
+             sim::tapCard(sim::readerForSs((uint8_t)atoi(a1)), uid, len);
+    } else if (!strcmp(kind, "key")) {
+        char one[2] = { a1[0], '\0' };
+        ok = sim::typeKeys(one);
+    } else if (!strcmp(kind, "eeprom")) {
+        ok = sim::loadEepromHex(a1);
+    } else {
+        ok = false;
+    }
+
+    if (!ok) sim::log("trace : entrée invalide (%s)", kind);
+}
+
+void pollReplay() {
+    while (entryReady && (long)(millis() - entryMs) >= 0) {
+        lastEntryMs = entryMs;
+        applyEntry(entry);
+        nextEntry();
+    }
+}
+
+bool replayDone() {
+    return !entryReady && sim::idle() && (millis() - lastEntryMs) >= settleMs;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *eepromPath = nullptr;
+    const char *recordPath = nullptr;
+    const char *replayPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--eeprom") && i + 1 < argc) {
+            eepromPath = argv[++i];
+        } else if (!strcmp(argv[i], "--link") && i + 1 < argc) {
+            linkPath = argv[++i];
+        } else if (!strcmp(argv[i], "--virtual")) {
+            sim::useVirtualClock(true);
+        } else if (!strcmp(argv[i], "--quiet")) {
+            sim::setVerbose(false);
+        } else if (!strcmp(argv[i], "--record") && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (!strcmp(argv[i], "--settle") && i + 1 < argc) {
+            settleMs = strtoul(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--echo")) {
+            sim::setEcho(true);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // Rejeu : l'état initial vient de la trace, pas d'un fichier EEPROM
+    if ((recordPath && replayPath) || (replayPath && eepromPath)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    sim::setKeypad(keys, rowPins, colPins, SIM_KEYPAD_ROWS, SIM_KEYPAD_COLS);
+
+    if (eepromPath && !sim::attachEeprom(eepromPath)) {
+        fprintf(stderr, "EEPROM : impossible d'ouvrir %s\n", eepromPath);
+        return 1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    if (replayPath) {
+        replayFile = fopen(replayPath, "r");
+        if (!replayFile) {
+            fprintf(stderr, "trace %s : %s\n", replayPath, strerror(errno));
+            return 1;
+        }
+        sim::useVirtualClock(true);
+        sim::setReplay(true);
+        sim::setEcho(true);
+
+        // Entrées à 0 ms (image EEPROM) : appliquées avant setup()
+        nextEntry();
+        pollReplay();
+    } else {
+        if (recordPath && !sim::startRecording(recordPath)) {
+            fprintf(stderr, "trace %s : %s\n", recordPath, strerror(errno));
+            return 1;
+        }
+
+        if (!sim::openSerial()) {
+            fprintf(stderr, "pty : %s\n", strerror(errno));
+            return 1;
+        }
+        if (linkPath) {
+            unlink(linkPath);
+            if (symlink(sim::serialPath(), linkPath) != 0) {
+                fprintf(stderr, "lien %s : %s\n", linkPath, strerror(errno));
+                return 1;
+            }
+            atexit(removeLink);
+        }
+        sim::log("port série : %s", linkPath ? linkPath : sim::serialPath());
+
+        // Horloge virtuelle : le scénario fixe seul la chronologie, stdin est lu en bloquant
+        if (!sim::virtualClock()) {
+            fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+        }
+    }
+
+    setup();
+    while (!quitRequested) {
+        loop();
+        sim::onLoop();
+
+        if (replayFile) {
+            pollReplay();
+            if (replayDone()) break;
+            continue;
+        }
+
+        pollControl();
+        if (sim::virtualClock() && inputClosed && lineLen == 0 && sim::idle() &&
+            (long)(millis() - waitUntilMs) >= 0) {
+            break;
+        }
+    }
+
+    sim::stopRecording();
+    sim::log("fin de simulation");
+    if (replayFile) sim::printStageCpu();
+    return 0;
+}
@@ -0,0 +1,147 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+/*
+  Arduino.h — backend Linux (simulateur natif)
+  - Sous-ensemble de l'API Arduino utilisé par le firmware : broches, tone,
+    millis/micros/delay, Serial (pty), interruptions (no-op, un seul thread).
+  - Brochage Mega 2560 (A0 = 54). Le comportement électrique (matrice clavier,
+    relais, buzzer) est modélisé par SimBoard.
+  - ARDUINO_ARCH_AVR n'est PAS défini : les modules prennent leurs chemins
+    génériques (scan clavier rattrapé dans update(), pas de watchdog / sleep).
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Chaînes "flash" : simple pointeur en natif
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define NOT_AN_INTERRUPT -1
+#define SIM_NUM_PINS 70
+
+#ifndef _BV
+#define _BV(bit) (1u << (bit))
+#endif
+
+enum : uint8_t {
+    A0 = 54, A1, A2, A3, A4, A5, A6, A7,
+    A8, A9, A10, A11, A12, A13, A14, A15
+};
+
+// Broches d'interruption externe du Mega : 2, 3, 18, 19, 20, 21
+inline int digitalPinToInterrupt(uint8_t p) {
+    switch (p) {
+        case 2: return 0;
+        case 3: return 1;
+        case 18: return 5;
+        case 19: return 4;
+        case 20: return 3;
+        case 21: return 2;
+        default: return NOT_AN_INTERRUPT;
+    }
+}
+
+template <class T, class U> inline auto min(T a, U b) -> decltype(a < b ? a : b) { return a < b ? a : b; }
+template <class T, class U> inline auto max(T a, U b) -> decltype(a > b ? a : b) { return a > b ? a : b; }
+
+/* ===== Temps ===== */
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/* ===== Broches ===== */
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+/* ===== Interruptions (simulateur mono-thread : rien à masquer) ===== */
+inline void noInterrupts() {}
+inline void interrupts() {}
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+/* ===== Print / Stream ===== */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t n);
+    size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+    virtual int availableForWrite() { return 64; }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC);
+    size_t print(unsigned long v, int base = DEC);
+    size_t print(double v, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <class T> size_t println(T v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    size_t readBytes(char *buf, size_t n) {
+        size_t i = 0;
+        for (int c; i < n && (c = read()) >= 0; i++) buf[i] = (char)c;
+        return i;
+    }
+};
+
+// Port série 0 : relié au côté maître d'un pseudo-terminal (SimBoard)
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud);
+    void end() {}
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t n) override;
+    using Print::write;
+    int availableForWrite() override;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,55 @@
+#ifndef SIM_EEPROM_H
+#define SIM_EEPROM_H
+
+/*
+  EEPROM.h — backend Linux : 4 Ko (Mega 2560) en RAM, recopiés dans un
+  fichier à chaque écriture (--eeprom) : le contenu survit aux redémarrages
+  du simulateur comme sur la carte. Effacée (0xFF) sans fichier.
+*/
+
+#include <Arduino.h>
+
+class EEPROMClass {
+public:
+    static const uint16_t SIZE = 4096;
+
+    EEPROMClass() { memset(data, 0xFF, sizeof(data)); }
+
+    uint8_t read(int idx) const;
+    void write(int idx, uint8_t val);
+    void update(int idx, uint8_t val);
+    uint16_t length() const { return SIZE; }
+
+    template <class T> T &get(int idx, T &t) const {
+        uint8_t *p = (uint8_t *)&t;
+        for (size_t i = 0; i < sizeof(T); i++) p[i] = read(idx + (int)i);
+        return t;
+    }
+    template <class T> const T &put(int idx, const T &t) {
+        const uint8_t *p = (const uint8_t *)&t;
+        for (size_t i = 0; i < sizeof(T); i++) update(idx + (int)i, p[i]);
+        return t;
+    }
+
+    // Simulateur : fichier de persistance (vide = RAM seule, effacé à 0xFF)
+    bool attach(const char *path);
+    uint32_t getWrites() const { return writes; }
+
+    // Simulateur : coupure d'alimentation après n écritures (les suivantes
+    // sont perdues), -1 = jamais. Pour les tests de migration / CRC.
+    void cutPowerAfter(long n) { writesLeft = n; }
+
+    // Simulateur : image complète (état initial d'une trace, rejeu)
+    const uint8_t *image() const { return data; }
+    void load(const uint8_t *img, size_t n) { memcpy(data, img, n < SIZE ? n : SIZE); }
+
+private:
+    uint8_t data[SIZE];
+    int fd = -1;
+    uint32_t writes = 0;
+    long writesLeft = -1;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // SIM_EEPROM_H
@@ -0,0 +1,63 @@
+#ifndef SIM_MFRC522_H
+#define SIM_MFRC522_H
+
+/*
+  MFRC522.h — backend Linux : lecteur simulé, même interface que la
+  bibliothèque miguelbalboa/MFRC522 pour les appels faits par RFIDModule.
+  - Le "champ" de chaque lecteur (carte posée ou non) est piloté par
+    SimBoard (commandes card / tap / remove du simulateur), lecteurs
+    numérotés dans l'ordre de construction.
+  - États ISO 14443-3 utiles au module : REQA ne réveille qu'une carte IDLE,
+    WUPA réveille aussi une carte HALT ; HaltA la met en HALT.
+*/
+
+#include <Arduino.h>
+#include <SPI.h>
+
+class MFRC522 {
+public:
+    enum PCD_Register : byte {
+        CommandReg = 0x01 << 1, ComIEnReg = 0x02 << 1, DivIEnReg = 0x03 << 1,
+        ComIrqReg = 0x04 << 1, DivIrqReg = 0x05 << 1, FIFODataReg = 0x09 << 1,
+        FIFOLevelReg = 0x0A << 1, BitFramingReg = 0x0D << 1, RFCfgReg = 0x26 << 1,
+        TModeReg = 0x2A << 1, TPrescalerReg = 0x2B << 1, TReloadRegH = 0x2C << 1,
+        TReloadRegL = 0x2D << 1, VersionReg = 0x37 << 1
+    };
+    enum PCD_Command : byte { PCD_Idle = 0x00, PCD_Transceive = 0x0C };
+    enum PCD_RxGain : byte {
+        RxGain_18dB = 0x00 << 4, RxGain_23dB = 0x01 << 4, RxGain_33dB = 0x04 << 4,
+        RxGain_38dB = 0x05 << 4, RxGain_43dB = 0x06 << 4, RxGain_48dB = 0x07 << 4,
+        RxGain_min = 0x00 << 4, RxGain_avg = 0x04 << 4, RxGain_max = 0x07 << 4
+    };
+    enum PICC_Command : byte { PICC_CMD_REQA = 0x26, PICC_CMD_WUPA = 0x52 };
+    enum StatusCode : byte {
+        STATUS_OK, STATUS_ERROR, STATUS_COLLISION, STATUS_TIMEOUT, STATUS_NO_ROOM,
+        STATUS_INTERNAL_ERROR, STATUS_INVALID, STATUS_CRC_WRONG, STATUS_MIFARE_NACK = 0xff
+    };
+
+    struct Uid {
+        byte size;
+        byte uidByte[10];
+        byte sak;
+    } uid;
+
+    MFRC522(byte ssPin, byte rstPin);
+
+    void PCD_Init() {}
+    void PCD_WriteRegister(PCD_Register, byte) {}
+    byte PCD_ReadRegister(PCD_Register reg) { return reg == VersionReg ? 0x92 : 0x00; }
+    void PCD_SetAntennaGain(byte mask) { gain = mask; }
+    byte PCD_GetAntennaGain() { return gain; }
+    void PCD_StopCrypto1() {}
+
+    bool PICC_IsNewCardPresent();
+    bool PICC_ReadCardSerial();
+    StatusCode PICC_WakeupA(byte *atqa, byte *atqaSize);
+    StatusCode PICC_HaltA();
+
+private:
+    uint8_t slot;   // index du lecteur dans SimBoard
+    byte gain = RxGain_avg;
+};
+
+#endif // SIM_MFRC522_H
@@ -0,0 +1,30 @@
+#ifndef SIM_SPI_H
+#define SIM_SPI_H
+
+/*
+  SPI.h — backend Linux : bus sans effet, le lecteur MFRC522 simulé
+  répond directement à ses appels de méthode.
+*/
+
+#include <Arduino.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0x00
+
+struct SPISettings {
+    SPISettings() {}
+    SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t) { return 0; }
+};
+
+extern SPIClass SPI;
+
+#endif // SIM_SPI_H
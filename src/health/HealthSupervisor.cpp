@@ -0,0 +1,248 @@
+#include "HealthSupervisor.h"
+
+#if defined(ARDUINO_ARCH_AVR)
+#include <avr/wdt.h>
+#include <avr/interrupt.h>
+
+// MCUSR doit être lu et effacé avant que le watchdog (resté armé après un
+// reset WDT, au timeout minimal) ne relance la carte en boucle.
+uint8_t mcusrMirror __attribute__((section(".noinit")));
+void captureMcusr() __attribute__((naked, used, section(".init3")));
+void captureMcusr() {
+    mcusrMirror = MCUSR;
+    MCUSR = 0;
+    wdt_disable();
+}
+
+// Instantané pris par l'ISR WDT : RAM non initialisée au boot, survit au
+// reset watchdog qui suit. Pas d'EEPROM dans l'ISR : elle pourrait couper
+// une écriture EEPROM de loop() (registres EEAR/EEDR partagés).
+struct WdtSnapshot {
+    uint8_t magic;
+    uint8_t culprit;
+    uint16_t misses[(uint8_t)Subsystem::COUNT];
+    uint8_t check;
+};
+WdtSnapshot wdtSnapshot __attribute__((section(".noinit")));
+
+static uint8_t snapshotCheck(const WdtSnapshot &s) {
+    const uint8_t *b = (const uint8_t *)&s;
+    uint8_t c = 0xA5;
+    for (uint8_t i = 0; i < offsetof(WdtSnapshot, check); i++) c ^= b[i];
+    return c;
+}
+#endif
+
+// Format du record EEPROM (EEPROMStore::HEALTH_SIZE octets) : dernier
+// incident watchdog, écrit par begin() et relu aux boots suivants.
+// Octets 1 et 3 réservés (0).
+static const uint8_t HEALTH_MAGIC = 0x5A;
+static const uint8_t REC_MAGIC = 0;
+static const uint8_t REC_CULPRIT = 2;
+static const uint8_t REC_MISSES = 4;    // uint16_t * Subsystem::COUNT
+
+HealthSupervisor *HealthSupervisor::instance = nullptr;
+
+HealthSupervisor::HealthSupervisor(EEPROMStore &storeRef)
+    : store(storeRef),
+      late(0),
+      seen(0),
+      resetReason(ResetReason::UNKNOWN),
+      culprit(0xFF),
+      fromRecord(false)
+{
+    memset(lastCheckIn, 0, sizeof(lastCheckIn));
+    memset(misses, 0, sizeof(misses));
+    memset(prevMisses, 0, sizeof(prevMisses));
+}
+
+void HealthSupervisor::begin() {
+    instance = this;
+
+#if defined(ARDUINO_ARCH_AVR)
+    if (mcusrMirror & _BV(WDRF)) resetReason = ResetReason::WATCHDOG;
+    else if (mcusrMirror & _BV(BORF)) resetReason = ResetReason::BROWN_OUT;
+    else if (mcusrMirror & _BV(EXTRF)) resetReason = ResetReason::EXTERNAL;
+    else if (mcusrMirror & _BV(PORF)) resetReason = ResetReason::POWER_ON;
+
+    // Reset watchdog précédé de l'ISR : instantané RAM -> record EEPROM,
+    // écrit ici, hors interruption, avant toute autre écriture EEPROM
+    if (resetReason == ResetReason::WATCHDOG && wdtSnapshot.magic == HEALTH_MAGIC &&
+        wdtSnapshot.check == snapshotCheck(wdtSnapshot)) {
+        culprit = wdtSnapshot.culprit;
+        uint8_t rec[EEPROMStore::HEALTH_SIZE];
+        memset(rec, 0, sizeof(rec));
+        rec[REC_MAGIC] = HEALTH_MAGIC;
+        rec[REC_CULPRIT] = culprit;
+        for (uint8_t i = 0; i < (uint8_t)Subsystem::COUNT; i++) {
+            prevMisses[i] = wdtSnapshot.misses[i];
+            rec[REC_MISSES + 2 * i] = prevMisses[i] & 0xFF;
+            rec[REC_MISSES + 2 * i + 1] = (prevMisses[i] >> 8) & 0xFF;
+        }
+        store.writeHealthRecord(rec);
+    }
+    wdtSnapshot.magic = 0;
+#endif
+
+    // Pas d'instantané ce boot (power-on, brown-out... la RAM .noinit est
+    // perdue) : rapporter le dernier incident gardé en EEPROM
+    if (culprit == 0xFF) {
+        uint8_t rec[EEPROMStore::HEALTH_SIZE];
+        store.readHealthRecord(rec);
+        if (rec[REC_MAGIC] == HEALTH_MAGIC && rec[REC_CULPRIT] < (uint8_t)Subsystem::COUNT) {
+            culprit = rec[REC_CULPRIT];
+            fromRecord = true;
+            for (uint8_t i = 0; i < (uint8_t)Subsystem::COUNT; i++) {
+                prevMisses[i] = rec[REC_MISSES + 2 * i] | ((uint16_t)rec[REC_MISSES + 2 * i + 1] << 8);
+            }
+        }
+    }
+
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < (uint8_t)Subsystem::COUNT; i++) {
+        lastCheckIn[i] = now;
+    }
+
+    armWatchdog();
+    DEBUG_PRINTLN(F("[HEALTH] Watchdog armé"));
+}
+
+void HealthSupervisor::checkIn(Subsystem s) {
+    uint8_t i = (uint8_t)s;
+    lastCheckIn[i] = millis();
+    seen |= (1 << i);
+    late &= ~(1 << i);
+}
+
+void HealthSupervisor::update() {
+    unsigned long now = millis();
+    const uint8_t all = (1 << (uint8_t)Subsystem::COUNT) - 1;
+
+    for (uint8_t i = 0; i < (uint8_t)Subsystem::COUNT; i++) {
+        if ((now - lastCheckIn[i]) > deadlineOf(i) && !(late & (1 << i))) {
+            late |= (1 << i);
+            misses[i]++;
+            DEBUG_PRINT(F("[HEALTH] Délai dépassé: "));
+            DEBUG_PRINTLN(subsystemName(i));
+        }
+    }
+
+    // Nourrir le watchdog seulement quand chaque sous-système a progressé
+    if ((seen & all) == all) {
+        kick();
+        seen = 0;
+    }
+}
+
+uint16_t HealthSupervisor::getMisses(Subsystem s) const {
+    return misses[(uint8_t)s];
+}
+
+ResetReason HealthSupervisor::getResetReason() const {
+    return resetReason;
+}
+
+void HealthSupervisor::attachBootReport(JsonObject dst) const {
+    dst["reset_reason"] = reasonName(resetReason);
+    // Incident d'un boot antérieur : sous "last_watchdog", pas à la racine
+    if (fromRecord) dst = dst.createNestedObject("last_watchdog");
+    if (culprit < (uint8_t)Subsystem::COUNT) {
+        dst["culprit"] = subsystemName(culprit);
+    }
+    JsonObject m = dst.createNestedObject("deadline_misses");
+    for (uint8_t i = 0; i < (uint8_t)Subsystem::COUNT; i++) {
+        m[subsystemName(i)] = prevMisses[i];
+    }
+}
+
+void HealthSupervisor::attachStats(JsonObject dst) const {
+    dst["reset_reason"] = reasonName(resetReason);
+    JsonObject m = dst.createNestedObject("deadline_misses");
+    for (uint8_t i = 0; i < (uint8_t)Subsystem::COUNT; i++) {
+        m[subsystemName(i)] = misses[i];
+    }
+}
+
+/* ===== PRIVATE ===== */
+
+unsigned long HealthSupervisor::deadlineOf(uint8_t s) {
+    switch ((Subsystem)s) {
+        case Subsystem::RFID: return HEALTH_DEADLINE_RFID_MS;
+        case Subsystem::RELAY: return HEALTH_DEADLINE_RELAY_MS;
+        case Subsystem::SERIAL_LINK: return HEALTH_DEADLINE_SERIAL_MS;
+        default: return 1000;
+    }
+}
+
+const char* HealthSupervisor::subsystemName(uint8_t s) {
+    switch ((Subsystem)s) {
+        case Subsystem::RFID: return "rfid";
+        case Subsystem::RELAY: return "relay";
+        case Subsystem::SERIAL_LINK: return "serial";
+        default: return "unknown";
+    }
+}
+
+const char* HealthSupervisor::reasonName(ResetReason r) {
+    switch (r) {
+        case ResetReason::POWER_ON: return "power_on";
+        case ResetReason::EXTERNAL: return "external";
+        case ResetReason::BROWN_OUT: return "brown_out";
+        case ResetReason::WATCHDOG: return "watchdog";
+        default: return "unknown";
+    }
+}
+
+void HealthSupervisor::armWatchdog() {
+#if defined(ARDUINO_ARCH_AVR)
+    // Mode interruption + reset : 1er timeout -> ISR (enregistrement), 2e -> reset
+    noInterrupts();
+    wdt_reset();
+    WDTCSR |= _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE) | _BV(WDE) | _BV(WDP2) | _BV(WDP1) | _BV(WDP0); // 2 s
+    interrupts();
+#endif
+}
+
+void HealthSupervisor::kick() {
+#if defined(ARDUINO_ARCH_AVR)
+    wdt_reset();
+    // L'ISR a eu lieu (le matériel efface alors WDIE) mais loop() est
+    // repartie : réarmer l'interruption, sans quoi le prochain timeout
+    // resetterait sans instantané, et oublier l'instantané (pas de reset)
+    if (!(WDTCSR & _BV(WDIE))) {
+        WDTCSR |= _BV(WDIE);
+        wdtSnapshot.magic = 0;
+    }
+#endif
+}
+
+void HealthSupervisor::onWatchdogTimeout() {
+    // Sous-système fautif : le plus ancien check-in
+    unsigned long now = millis();
+    uint8_t worst = 0;
+    unsigned long worstAge = 0;
+    for (uint8_t i = 0; i < (uint8_t)Subsystem::COUNT; i++) {
+        unsigned long age = now - lastCheckIn[i];
+        if (age >= worstAge) {
+            worstAge = age;
+            worst = i;
+        }
+    }
+    misses[worst]++;
+
+#if defined(ARDUINO_ARCH_AVR)
+    wdtSnapshot.culprit = worst;
+    memcpy(wdtSnapshot.misses, misses, sizeof(wdtSnapshot.misses));
+    wdtSnapshot.magic = HEALTH_MAGIC;
+    wdtSnapshot.check = snapshotCheck(wdtSnapshot);
+#endif
+}
+
+#if defined(ARDUINO_ARCH_AVR)
+ISR(WDT_vect) {
+    if (HealthSupervisor::instance) {
+        HealthSupervisor::instance->onWatchdogTimeout();
+    }
+}
+#endif
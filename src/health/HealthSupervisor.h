@@ -0,0 +1,85 @@
+#ifndef HEALTH_SUPERVISOR_H
+#define HEALTH_SUPERVISOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+#include "../eeprom/EEPROMStore.h"
+
+/*
+  HealthSupervisor
+  - Arme le watchdog matériel (mode interruption + reset, WDT_TIMEOUT 2 s)
+  - Chaque sous-système critique fait checkIn() quand il a réellement
+    progressé, dans son délai (au-dessus des blocages connus de loop()) :
+      RFID   : après un passage de ReaderScheduler::poll()
+      RELAY  : RelayBank::update() sans échéance servie en retard
+      SERIAL : tampon de réception vidé (ou commande tenue pour la FSM)
+  - update() (fin de loop) : le watchdog n'est nourri que si TOUS les
+    sous-systèmes se sont signalés depuis le dernier kick. Un dépassement
+    de délai est compté une fois par épisode.
+  - Si le watchdog expire, l'ISR WDT note le sous-système fautif et les
+    compteurs en RAM .noinit ; le reset matériel suit au timeout suivant
+    et begin() recopie cet instantané en EEPROM. Si loop() repart avant,
+    kick() réarme l'interruption et oublie l'instantané.
+  - Au boot : cause du dernier reset (watchdog / power-on / brown-out / externe)
+    rapportée par un événement JsonComm "boot". Sans instantané (la RAM
+    .noinit ne survit pas à une coupure), le dernier incident gardé en
+    EEPROM est rapporté sous "last_watchdog".
+*/
+
+enum class Subsystem : uint8_t {
+    RFID,
+    RELAY,
+    SERIAL_LINK,
+    COUNT
+};
+
+enum class ResetReason : uint8_t {
+    UNKNOWN,
+    POWER_ON,
+    EXTERNAL,
+    BROWN_OUT,
+    WATCHDOG
+};
+
+class HealthSupervisor {
+public:
+    HealthSupervisor(EEPROMStore &store);
+
+    void begin();                  // lit la cause du reset puis arme le watchdog
+    void checkIn(Subsystem s);
+    void update();                 // fin de loop(): comptage des retards + kick WDT
+
+    uint16_t getMisses(Subsystem s) const;
+    ResetReason getResetReason() const;
+
+    void attachBootReport(JsonObject dst) const;  // cause + sous-système fautif + compteurs précédents
+    void attachStats(JsonObject dst) const;       // compteurs courants
+
+private:
+    EEPROMStore &store;
+
+    unsigned long lastCheckIn[(uint8_t)Subsystem::COUNT];
+    uint16_t misses[(uint8_t)Subsystem::COUNT];
+    uint8_t late;        // bitmask : sous-systèmes déjà comptés en retard
+    uint8_t seen;        // bitmask : check-ins depuis le dernier kick
+
+    ResetReason resetReason;
+    uint8_t culprit;     // sous-système fautif au dernier reset watchdog (0xFF = aucun)
+    uint16_t prevMisses[(uint8_t)Subsystem::COUNT];
+    bool fromRecord;     // culprit/prevMisses relus du record EEPROM (boot antérieur)
+
+    static unsigned long deadlineOf(uint8_t s);
+    static const char* subsystemName(uint8_t s);
+    static const char* reasonName(ResetReason r);
+
+    void armWatchdog();
+    void kick();
+
+public:
+    // Utilisés par l'ISR WDT uniquement
+    static HealthSupervisor *instance;
+    void onWatchdogTimeout();
+};
+
+#endif // HEALTH_SUPERVISOR_H
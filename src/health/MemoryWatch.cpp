@@ -0,0 +1,173 @@
+#include "MemoryWatch.h"
+
+#if defined(ARDUINO_ARCH_AVR)
+// Symboles de l'éditeur de liens et de malloc (avr-libc)
+extern char __heap_start;
+extern char *__brkval;
+extern size_t __malloc_margin;
+struct __freelist {
+    size_t sz;
+    struct __freelist *nx;
+};
+extern struct __freelist *__flp;
+
+static uintptr_t heapTop() {
+    return __brkval ? (uintptr_t)__brkval : (uintptr_t)&__heap_start;
+}
+#endif
+
+MemoryWatch::MemoryWatch()
+    : stackLow(0),
+      heapHigh(0),
+      stackStage(LoopStage::SETUP),
+      heapStage(LoopStage::SETUP),
+      loopsSinceScan(0),
+      painted(false)
+{
+}
+
+void MemoryWatch::begin() {
+#if defined(ARDUINO_ARCH_AVR)
+    // Interruptions coupées : une ISR empilerait son cadre dans la zone peinte
+    noInterrupts();
+    uintptr_t lo = heapTop();
+    uintptr_t hi = (uintptr_t)SP - MEM_PAINT_GUARD;   // cadre courant épargné
+    for (uintptr_t p = lo; p < hi; p++) {
+        *(volatile uint8_t *)p = MEM_PAINT;
+    }
+    interrupts();
+    stackLow = hi;
+    heapHigh = lo;
+    painted = true;
+#endif
+}
+
+void MemoryWatch::mark(LoopStage stage) {
+#if defined(ARDUINO_ARCH_AVR)
+    if (!painted) return;
+
+    // Tas : sommet de malloc (__brkval), bloc alloué compté même s'il n'est pas écrit
+    uintptr_t top = heapTop();
+    if (top > heapHigh) {
+        heapHigh = top;
+        heapStage = stage;
+    }
+
+    // Pile : SP pointe sur le premier octet libre, SP + 1 est écrit
+    uintptr_t sp = (uintptr_t)SP + 1;
+    if (sp < stackLow) {
+        stackLow = sp;
+        stackStage = stage;
+    }
+
+#ifdef MEM_WATCH_STAGE_SCAN
+    scanStack(stage);
+#endif
+#else
+    (void)stage;
+#endif
+}
+
+void MemoryWatch::update() {
+    if (++loopsSinceScan < MEM_SCAN_EVERY_LOOPS) return;
+    loopsSinceScan = 0;
+    scan();
+}
+
+void MemoryWatch::scan() {
+    scanStack(LoopStage::COUNT);   // pic survenu depuis le dernier scan, étape inconnue
+}
+
+uint16_t MemoryWatch::freeRam() const {
+#if defined(ARDUINO_ARCH_AVR)
+    return (uint16_t)((uintptr_t)SP - heapTop());
+#else
+    return 0;
+#endif
+}
+
+uint16_t MemoryWatch::peakStack() const {
+#if defined(ARDUINO_ARCH_AVR)
+    return painted ? (uint16_t)(RAMEND + 1 - stackLow) : 0;
+#else
+    return 0;
+#endif
+}
+
+uint16_t MemoryWatch::peakHeap() const {
+#if defined(ARDUINO_ARCH_AVR)
+    return painted ? (uint16_t)(heapHigh - (uintptr_t)&__heap_start) : 0;
+#else
+    return 0;
+#endif
+}
+
+uint16_t MemoryWatch::largestFreeBlock() const {
+#if defined(ARDUINO_ARCH_AVR)
+    size_t best = 0;
+    for (struct __freelist *f = __flp; f; f = f->nx) {
+        if (f->sz > best) best = f->sz;
+    }
+    // Au-dessus du tas : malloc garde __malloc_margin sous la pile + l'en-tête de taille
+    uintptr_t top = heapTop();
+    uintptr_t limit = (uintptr_t)SP - __malloc_margin;
+    if (limit > top + sizeof(size_t) && limit - top - sizeof(size_t) > best) {
+        best = limit - top - sizeof(size_t);
+    }
+    return (uint16_t)best;
+#else
+    return 0;
+#endif
+}
+
+uint16_t MemoryWatch::minFreeRam() const {
+    return painted ? (uint16_t)(stackLow - heapHigh) : 0;
+}
+
+void MemoryWatch::attachStats(JsonObject dst) const {
+    dst["free_ram"] = freeRam();
+    dst["min_free"] = minFreeRam();
+
+    JsonObject st = dst.createNestedObject("stack");
+    st["peak"] = peakStack();
+    st["stage"] = stageName(stackStage);
+
+    JsonObject hp = dst.createNestedObject("heap");
+    hp["peak"] = peakHeap();
+    hp["largest_free"] = largestFreeBlock();
+    hp["stage"] = stageName(heapStage);
+}
+
+/* ===== PRIVATE ===== */
+
+void MemoryWatch::scanStack(LoopStage stage) {
+#if defined(ARDUINO_ARCH_AVR)
+    if (!painted) return;
+
+    // Premier octet écrasé en montant depuis le tas. Un tampon local jamais
+    // rempli laisse un trou de motif dans son cadre : balayer depuis le tas
+    // (et non depuis l'ancien pic) trouve quand même les cadres plus profonds.
+    const volatile uint8_t *p = (const volatile uint8_t *)heapHigh;
+    const volatile uint8_t *end = (const volatile uint8_t *)stackLow;
+    while (p < end && *p == MEM_PAINT) p++;
+    if (p < end) {
+        stackLow = (uintptr_t)p;
+        stackStage = stage;
+    }
+#else
+    (void)stage;
+#endif
+}
+
+const char* MemoryWatch::stageName(LoopStage s) {
+    switch (s) {
+        case LoopStage::SETUP: return "setup";
+        case LoopStage::INPUTS: return "inputs";
+        case LoopStage::SERIAL_RX: return "serial";
+        case LoopStage::RFID: return "rfid";
+        case LoopStage::ACTION: return "action";
+        case LoopStage::WAIT_STATE: return "wait";
+        case LoopStage::HOUSEKEEPING: return "housekeeping";
+        default: return "?";
+    }
+}
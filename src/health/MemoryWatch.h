@@ -0,0 +1,69 @@
+#ifndef MEMORY_WATCH_H
+#define MEMORY_WATCH_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+
+/*
+  MemoryWatch
+  - begin() (setup) : peint la RAM libre entre le haut du tas et la pile
+    courante avec MEM_PAINT.
+  - mark(stage) en fin d'étape de loop(), O(1) ; un nouveau pic est
+    attribué à l'étape qui vient de finir :
+    - tas : max de __brkval relevé (bloc alloué, écrit ou non) ;
+    - pile : SP échantillonné (borne basse du pic).
+  - scan() : pic de pile exact (ISR comprises), octet écrasé le plus bas
+    cherché en montant depuis le pic du tas jusqu'au pic connu. Les trous
+    de motif (tampon local jamais rempli) ne faussent pas le résultat.
+    Coût ~0,5 ms par Ko de zone jamais atteinte à 16 MHz : appelé par
+    update() toutes les MEM_SCAN_EVERY_LOOPS boucles et avant un rapport.
+    Pic trouvé ainsi : étape inconnue ("?"). MEM_WATCH_STAGE_SCAN relit à
+    chaque mark() pour l'attribuer (diagnostic, ~10-15 ms par boucle).
+  - Fragmentation : plus grand bloc libre = max(liste libre de malloc,
+    espace entre le haut du tas et la pile moins __malloc_margin).
+  - Commande série "mem" : RAM libre, pics pile/tas + étape, plus grand bloc.
+  - Hors AVR (simulateur, bancs) : pas de peinture, valeurs à 0.
+*/
+
+enum class LoopStage : uint8_t {
+    SETUP,
+    INPUTS,      // clavier + relais
+    SERIAL_RX,   // réception + commandes diagnostic
+    RFID,
+    ACTION,      // actions FSM (badge, PIN, commandes admin)
+    WAIT_STATE,  // attente badge / confirmation
+    HOUSEKEEPING,// horloge, journal, watchdog, sommeil
+    COUNT
+};
+
+class MemoryWatch {
+public:
+    MemoryWatch();
+
+    void begin();                  // peint la zone libre (à appeler tôt dans setup)
+    void mark(LoopStage stage);    // fin d'étape : pic du tas, SP échantillonné
+    void update();                 // housekeeping : scan() toutes les MEM_SCAN_EVERY_LOOPS boucles
+    void scan();                   // relecture de la zone peinte : pic de pile exact
+
+    uint16_t freeRam() const;          // octets entre le haut du tas et la pile, maintenant
+    uint16_t peakStack() const;        // profondeur max de pile depuis le boot
+    uint16_t peakHeap() const;         // taille max du tas depuis begin()
+    uint16_t largestFreeBlock() const; // plus grand malloc() possible, maintenant
+    uint16_t minFreeRam() const;       // zone peinte jamais touchée (marge réelle restante)
+
+    void attachStats(JsonObject dst) const;
+
+private:
+    uintptr_t stackLow;    // plus basse adresse écrite par la pile
+    uintptr_t heapHigh;    // max de __brkval relevé (exclu)
+    LoopStage stackStage;
+    LoopStage heapStage;
+    uint16_t loopsSinceScan;
+    bool painted;
+
+    void scanStack(LoopStage stage);
+    static const char* stageName(LoopStage s);
+};
+
+#endif // MEMORY_WATCH_H
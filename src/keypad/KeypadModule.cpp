@@ -1,147 +1,334 @@
 #include "KeypadModule.h"
 #include "../config.h"
+#include "../trace/InputTrace.h"
 
+static_assert((KEYPAD_EVENT_QUEUE & (KEYPAD_EVENT_QUEUE - 1)) == 0,
+              "KEYPAD_EVENT_QUEUE doit être une puissance de 2");
+static_assert(KEYPAD_DEBOUNCE_SCANS >= 1, "KEYPAD_DEBOUNCE_SCANS >= 1");
 
-KeypadModule::KeypadModule(char* keysMap,
-                           byte* rowPins,
-                           byte* colPins,
-                           byte rows,
-                           byte cols,
-                           const char* defaultPIN,
-                           uint8_t buzzerPin)
-    : keypad(makeKeymap(keysMap), rowPins, colPins, rows, cols),
-      inputBuffer(""),
-      adminPIN(defaultPIN),
+KeypadModule *KeypadModule::instance = nullptr;
+
+#if defined(ARDUINO_ARCH_AVR)
+// Timer0 est déjà configuré par le core (millis(), débordement ~1 kHz) :
+// la comparaison B ajoute une interruption au même rythme, décalée d'une demi-période.
+ISR(TIMER0_COMPB_vect) {
+    KeypadModule::onTimerTick();
+}
+#endif
+
+KeypadModule::KeypadModule(const char *keysMap,
+                           const byte *rowPinsIn,
+                           const byte *colPinsIn,
+                           byte rowsIn,
+                           byte colsIn,
+                           const char *defaultPIN,
+                           Buzzer *buzzerIn)
+    : keymap(keysMap),
+      rowPins(rowPinsIn),
+      colPins(colPinsIn),
+      rows(rowsIn > MAX_ROWS ? MAX_ROWS : rowsIn),
+      cols(colsIn > MAX_COLS ? MAX_COLS : colsIn),
+      scanRow(0),
+      scanBits(0),
+      historyPos(0),
+      debounced(0),
+      head(0),
+      tail(0),
+      dropped(0),
+      maxDepth(0),
+      eventPending(false),
+      maxLagMs(0),
+#if !defined(ARDUINO_ARCH_AVR)
+      lastTickMs(0),
+#endif
+      inputLen(0),
+      pinLen(0),
       commandReady(false),
-      attemptsLeft(MAX_ATTEMPTS),
-      locked(false),
-      buzzer(buzzerPin)
+      buzzer(buzzerIn)
 {
+    memset(history, 0, sizeof(history));
+    memset(inputBuffer, 0, sizeof(inputBuffer));
+    memset(adminPIN, 0, sizeof(adminPIN));
+    changeAdminPIN(defaultPIN);
 }
 
 void KeypadModule::begin() {
     DEBUG_PRINTLN(F("[KEYPAD] Initialisation"));
-    inputBuffer.reserve(16);
     resetBuffer();
 
-    DEBUG_PRINT(F("[KEYPAD] PIN admin configuré | Tentatives="));
-    DEBUG_PRINTLN(attemptsLeft);
-
-    if (buzzer != 255) {
-        pinMode(buzzer, OUTPUT);
+    // Lignes flottantes (INPUT, PORT à 0) : seule la ligne scannée passe en sortie LOW
+    for (uint8_t r = 0; r < rows; r++) {
+        pinMode(rowPins[r], INPUT);
+        digitalWrite(rowPins[r], LOW);
+#if defined(ARDUINO_ARCH_AVR)
+        rowDdr[r] = portModeRegister(digitalPinToPort(rowPins[r]));
+        rowMask[r] = digitalPinToBitMask(rowPins[r]);
+#endif
+    }
+    for (uint8_t c = 0; c < cols; c++) {
+        pinMode(colPins[c], INPUT_PULLUP);
+#if defined(ARDUINO_ARCH_AVR)
+        colIn[c] = portInputRegister(digitalPinToPort(colPins[c]));
+        colMask[c] = digitalPinToBitMask(colPins[c]);
+#endif
     }
-}
-
-void KeypadModule::update() {
-    if (locked) return;
 
-    char key = keypad.getKey();
-    if (!key) return;
+    scanRow = 0;
+    driveRow(0, true);
+    instance = this;
 
-    beep(3000, 40);
+#if defined(ARDUINO_ARCH_AVR)
+    noInterrupts();
+    OCR0B = 0x80;
+    TIMSK0 |= _BV(OCIE0B);
+    interrupts();
+#else
+    lastTickMs = millis();
+#endif
 
-    DEBUG_PRINT(F("[KEYPAD] Touche: "));
-    DEBUG_PRINTLN(key);
+    DEBUG_PRINTLN(F("[KEYPAD] PIN admin configuré"));
+}
 
-    if (key == '*') {
-        resetBuffer();
-        return;
+bool KeypadModule::update() {
+#if !defined(ARDUINO_ARCH_AVR)
+    // Sans tick matériel : rattrape les ticks écoulés (borné à un cycle d'anti-rebond)
+    unsigned long now = millis();
+    uint8_t budget = rows * KEYPAD_DEBOUNCE_SCANS;
+    while ((now - lastTickMs) >= 1 && budget-- > 0) {
+        lastTickMs++;
+        scanTick();
     }
-
-    if (key == '#') {
-        commandReady = true;
-        DEBUG_PRINTLN(F("[KEYPAD] Commande complète"));
-        return;
+    if ((now - lastTickMs) >= 1) lastTickMs = now;
+#endif
+
+    eventPending = false;   // remis à true par l'ISR si une touche arrive pendant le vidage
+
+    bool handled = false;
+    KeyEvent ev;
+    // Commande en attente de lecture : les touches suivantes restent dans la file
+    while (!commandReady && pop(ev)) {
+        uint16_t lag = (uint16_t)millis() - ev.ms;
+        if (lag > maxLagMs) maxLagMs = lag;
+        INPUT_TRACE_KEY(ev.key);
+        processKey(ev.key);
+        handled = true;
     }
-
-    inputBuffer += key;
+    return handled;
 }
 
 bool KeypadModule::isCommandReady() const {
     return commandReady;
 }
 
-String KeypadModule::getCommand() {
-    if (!commandReady) return "";
+size_t KeypadModule::getCommand(char *out, size_t outSize) {
+    if (!out || outSize == 0) return 0;
+    out[0] = '\0';
+    if (!commandReady) return 0;
 
-    String cmd = inputBuffer;
+    size_t n = inputLen < outSize - 1 ? inputLen : outSize - 1;
+    memcpy(out, inputBuffer, n);
+    out[n] = '\0';
 
     DEBUG_PRINT(F("[KEYPAD] Commande lue: "));
-    DEBUG_PRINTLN(cmd);
+    DEBUG_PRINTLN(out);
 
     resetBuffer();
-    return cmd;
+    return n;
 }
 
-bool KeypadModule::checkAdminPIN(String pin) {
-    if (locked) return false;
+bool KeypadModule::checkAdminPIN(const char *pin) {
+    if (!pin) return false;
 
-    pin.trim();
+    // trim sans copie : ignorer les espaces en tête / fin
+    while (*pin == ' ' || *pin == '\t') pin++;
+    size_t len = strlen(pin);
+    while (len > 0 && (pin[len - 1] == ' ' || pin[len - 1] == '\t')) len--;
 
-    DEBUG_PRINT(F("[KEYPAD] Vérification PIN: "));
-    DEBUG_PRINTLN(pin);
+    DEBUG_PRINTLN(F("[KEYPAD] Vérification PIN"));
+
+    // Comparaison à temps constant : toujours MAX_PIN octets parcourus,
+    // la longueur participe au résultat sans court-circuit.
+    uint8_t diff = (len == pinLen) ? 0 : 1;
+    for (uint8_t i = 0; i < MAX_PIN; i++) {
+        char c = (i < len) ? pin[i] : '\0';
+        diff |= (uint8_t)(c ^ adminPIN[i]);
+    }
+    if (len > MAX_PIN) diff |= 1;
 
-    if (pin == adminPIN) {
+    if (diff == 0) {
         DEBUG_PRINTLN(F("[KEYPAD] PIN OK"));
-        attemptsLeft = MAX_ATTEMPTS;
-        beep(2000, 150);
+        beep(2000, 150, BuzzPriority::PIN_RESULT);
         resetBuffer();
         return true;
     }
 
-    attemptsLeft--;
-    beep(400, 300);
-
-    DEBUG_PRINT(F("[KEYPAD] PIN incorrect | Tentatives restantes: "));
-    DEBUG_PRINTLN(attemptsLeft);
+    beep(400, 300, BuzzPriority::PIN_RESULT);
+    DEBUG_PRINTLN(F("[KEYPAD] PIN incorrect"));
 
     resetBuffer();
-
-    if (attemptsLeft == 0) {
-        locked = true;
-        DEBUG_PRINTLN(F("[KEYPAD] CLAVIER BLOQUÉ"));
-    }
-
     return false;
 }
 
 /* ===== CORRECTION MINIMALE =====
    Empêcher l'écrasement du PIN admin par une valeur vide
 */
-bool KeypadModule::changeAdminPIN(const String& newPin) {
-    if (newPin.length() < 3 || newPin.length() > 8) {
-        DEBUG_PRINTLN(F("[KEYPAD] Nouveau PIN invalide"));
+bool KeypadModule::changeAdminPIN(const char *newPin) {
+    size_t len = newPin ? strlen(newPin) : 0;
+
+    if (len == 0) {
+        DEBUG_PRINTLN(F("[KEYPAD] PIN vide ignoré"));
         return false;
     }
 
-    if (newPin.length() == 0) {
-        DEBUG_PRINTLN(F("[KEYPAD] PIN vide ignoré"));
+    if (len < 3 || len > MAX_PIN) {
+        DEBUG_PRINTLN(F("[KEYPAD] Nouveau PIN invalide"));
         return false;
     }
 
-    adminPIN = newPin;
-    DEBUG_PRINT(F("[KEYPAD] Nouveau PIN admin défini: "));
-    DEBUG_PRINTLN(adminPIN);
+    memset(adminPIN, 0, sizeof(adminPIN));
+    memcpy(adminPIN, newPin, len);
+    pinLen = len;
+    DEBUG_PRINTLN(F("[KEYPAD] Nouveau PIN admin défini"));
 
     return true;
 }
 
-uint8_t KeypadModule::getRemainingAttempts() const {
-    return attemptsLeft;
+volatile bool *KeypadModule::eventFlag() {
+    return &eventPending;
+}
+
+void KeypadModule::attachStats(JsonObject out) {
+    noInterrupts();
+    uint16_t lost = dropped;
+    uint8_t depth = maxDepth;
+    interrupts();
+
+    out["dropped"] = lost;
+    out["max_depth"] = depth;
+    out["max_lag_ms"] = maxLagMs;
 }
 
-bool KeypadModule::isLocked() const {
-    return locked;
+void KeypadModule::onTimerTick() {
+    if (instance) instance->scanTick();
 }
 
 /* ===== PRIVATE ===== */
 
+void KeypadModule::scanTick() {
+    if (rows == 0) return;
+
+    // La ligne a été mise à LOW au tick précédent : colonnes stabilisées
+    uint8_t base = scanRow * cols;
+    for (uint8_t c = 0; c < cols; c++) {
+        if (columnLow(c)) scanBits |= (uint16_t)1 << (base + c);
+    }
+
+    driveRow(scanRow, false);
+    if (++scanRow >= rows) {
+        scanRow = 0;
+        debounce();
+        scanBits = 0;
+    }
+    driveRow(scanRow, true);
+}
+
+void KeypadModule::driveRow(uint8_t r, bool active) {
+#if defined(ARDUINO_ARCH_AVR)
+    // PORT déjà à 0 : DDR seul bascule entre sortie LOW et entrée flottante
+    if (active) *rowDdr[r] |= rowMask[r];
+    else *rowDdr[r] &= (uint8_t)~rowMask[r];
+#else
+    pinMode(rowPins[r], active ? OUTPUT : INPUT);
+    if (active) digitalWrite(rowPins[r], LOW);
+#endif
+}
+
+bool KeypadModule::columnLow(uint8_t c) const {
+#if defined(ARDUINO_ARCH_AVR)
+    return (*colIn[c] & colMask[c]) == 0;
+#else
+    return digitalRead(colPins[c]) == LOW;
+#endif
+}
+
+void KeypadModule::debounce() {
+    history[historyPos] = scanBits;
+    historyPos = (historyPos + 1) % KEYPAD_DEBOUNCE_SCANS;
+
+    // Bit à 1 dans allDown : appuyée sur tous les balayages ; allUp : relâchée sur tous
+    uint16_t allDown = 0xFFFF;
+    uint16_t allUp = 0xFFFF;
+    for (uint8_t i = 0; i < KEYPAD_DEBOUNCE_SCANS; i++) {
+        allDown &= history[i];
+        allUp &= (uint16_t)~history[i];
+    }
+
+    uint16_t next = (debounced | allDown) & (uint16_t)~allUp;
+    uint16_t pressed = next & (uint16_t)~debounced;
+    debounced = next;
+
+    for (uint8_t bit = 0; pressed; bit++, pressed >>= 1) {
+        if (pressed & 1) push(keymap[bit]);
+    }
+}
+
+void KeypadModule::push(char key) {
+    uint8_t next = (head + 1) & (KEYPAD_EVENT_QUEUE - 1);
+    if (next == tail) {
+        dropped++;
+        return;
+    }
+    queue[head].key = key;
+    queue[head].ms = (uint16_t)millis();
+    head = next;
+
+    uint8_t depth = (head - tail) & (KEYPAD_EVENT_QUEUE - 1);
+    if (depth > maxDepth) maxDepth = depth;
+    eventPending = true;
+}
+
+bool KeypadModule::pop(KeyEvent &ev) {
+    uint8_t t = tail;
+    if (t == head) return false;
+    ev = queue[t];   // l'ISR n'écrit pas cette case tant que tail n'a pas avancé
+    tail = (t + 1) & (KEYPAD_EVENT_QUEUE - 1);
+    return true;
+}
+
+void KeypadModule::processKey(char key) {
+    beep(3000, 40, BuzzPriority::KEY_CLICK);
+
+    DEBUG_PRINT(F("[KEYPAD] Touche: "));
+    DEBUG_PRINTLN(key);
+
+    if (key == '*') {
+        resetBuffer();
+        return;
+    }
+
+    if (key == '#') {
+        commandReady = true;
+        DEBUG_PRINTLN(F("[KEYPAD] Commande complète"));
+        return;
+    }
+
+    if (inputLen >= MAX_INPUT) {
+        DEBUG_PRINTLN(F("[KEYPAD] Saisie trop longue, touche ignorée"));
+        return;
+    }
+
+    inputBuffer[inputLen++] = key;
+    inputBuffer[inputLen] = '\0';
+}
+
+
 void KeypadModule::resetBuffer() {
-    inputBuffer = "";
+    inputLen = 0;
+    inputBuffer[0] = '\0';
     commandReady = false;
 }
 
-void KeypadModule::beep(uint16_t freq, uint16_t duration) {
-    if (buzzer == 255) return;
-    tone(buzzer, freq, duration);
-}
\ No newline at end of file
+void KeypadModule::beep(uint16_t freq, uint16_t duration, BuzzPriority priority) {
+    if (!buzzer) return;
+    buzzer->play(freq, duration, priority);
+}
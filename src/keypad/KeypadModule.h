@@ -2,53 +2,120 @@
 #define KEYPAD_MODULE_H
 
 #include <Arduino.h>
-#include <Keypad.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+#include "../ui/Buzzer.h"
 
 /*
   KeypadModule
-  - Simple wrapper around Keypad library.
-  - NOTE: currently uses String for compatibility with existing main.cpp.
-    If memory constraints force it, we can refactor to c-strings later.
+  - Matrix scan on a fixed timer tick, independent of loop() timing:
+    Timer0 COMPB interrupt (~1 kHz, same timer as millis()), one row per tick.
+    A row is driven LOW while the others float; columns are INPUT_PULLUP.
+  - Debounce in bitmasks: one bit per key, a key changes state only after
+    KEYPAD_DEBOUNCE_SCANS identical full scans (no per-key timers).
+  - Each debounced press is pushed, timestamped, into a ring buffer
+    (KEYPAD_EVENT_QUEUE) written by the ISR and drained by update():
+    a long delay() elsewhere in loop() no longer loses keystrokes.
+  - update() stops draining while a command is waiting to be read:
+    keys typed after '#' stay queued for the next command.
+  - eventFlag(): set by the ISR on each press, for PowerManager::watchFlag()
+    (wakes the MCU from idle sleep, Timer0 keeps running in SLEEP_MODE_IDLE).
+  - Key clicks and PIN result tones go through the shared Buzzer.
+  - No heap: input and admin PIN live in fixed char buffers with explicit lengths.
+  - Admin PIN comparison is constant-time (does not leak the matching prefix length).
+  - No attempt counting here: lockout is per input source (LockoutPolicy).
 */
 
+struct KeyEvent {
+    char key;
+    uint16_t ms;    // (uint16_t)millis() à l'appui validé
+};
+
 class KeypadModule {
 public:
-    static const uint8_t MAX_ATTEMPTS = 5;
+    static const uint8_t MAX_INPUT = CMD_MAX_LEN; // touches mémorisées avant '#'
+    static const uint8_t MAX_PIN = 8;
+    static const uint8_t MAX_ROWS = 4;
+    static const uint8_t MAX_COLS = 4;            // MAX_ROWS x MAX_COLS <= 16 bits
 
-    KeypadModule(char* keysMap,
-                 byte* rowPins,
-                 byte* colPins,
+    KeypadModule(const char *keysMap,
+                 const byte *rowPins,
+                 const byte *colPins,
                  byte rows,
                  byte cols,
-                 const char* defaultPIN = "123",
-                 uint8_t buzzerPin = 255);
+                 const char *defaultPIN = "123",
+                 Buzzer *buzzer = nullptr);
 
-    void begin();
-    void update();
+    void begin();                         // configure les broches, démarre le tick
+    bool update();                        // true si au moins une touche a été traitée
 
     bool isCommandReady() const;
-    String getCommand();                  // retourne la commande SANS '#'
+    size_t getCommand(char *out, size_t outSize); // copie la commande SANS '#', retourne sa longueur
+
+    bool checkAdminPIN(const char *pin);          // pin attendu sans '#'
+    bool changeAdminPIN(const char *newPin);
 
-    bool checkAdminPIN(String pin);       // pin attendu sans '#'
-    bool changeAdminPIN(const String& newPin);
+    volatile bool *eventFlag();
 
-    uint8_t getRemainingAttempts() const;
-    bool isLocked() const;
+    // Diagnostic : touches perdues (file pleine), profondeur max de la file,
+    // attente max entre l'appui et son traitement par update()
+    void attachStats(JsonObject out);
+
+    static void onTimerTick();            // ISR Timer0 COMPB
 
 private:
-    Keypad keypad;
+    static KeypadModule *instance;        // cible de l'ISR (un seul clavier)
+
+    const char *keymap;
+    const byte *rowPins;
+    const byte *colPins;
+    uint8_t rows;
+    uint8_t cols;
 
-    String inputBuffer;
-    String adminPIN;
+    // ----- état du scan (ISR uniquement) -----
+    uint8_t scanRow;
+    uint16_t scanBits;                    // balayage en cours, bit = ligne * cols + colonne
+    uint16_t history[KEYPAD_DEBOUNCE_SCANS];
+    uint8_t historyPos;
+    uint16_t debounced;                   // touches appuyées, validées
+
+    // ----- file ISR -> loop() -----
+    KeyEvent queue[KEYPAD_EVENT_QUEUE];
+    volatile uint8_t head;                // écrit par l'ISR
+    volatile uint8_t tail;                // écrit par update()
+    volatile uint16_t dropped;
+    volatile uint8_t maxDepth;
+    volatile bool eventPending;
+    uint16_t maxLagMs;
+
+#if defined(ARDUINO_ARCH_AVR)
+    volatile uint8_t *rowDdr[MAX_ROWS];
+    uint8_t rowMask[MAX_ROWS];
+    volatile uint8_t *colIn[MAX_COLS];
+    uint8_t colMask[MAX_COLS];
+#else
+    unsigned long lastTickMs;             // pas de tick matériel : scan rattrapé dans update()
+#endif
+
+    char inputBuffer[MAX_INPUT + 1];
+    uint8_t inputLen;
+    char adminPIN[MAX_PIN + 1];   // zéro-complété jusqu'à MAX_PIN
+    uint8_t pinLen;
 
     bool commandReady;
-    uint8_t attemptsLeft;
-    bool locked;
 
-    uint8_t buzzer;
+    Buzzer *buzzer;
+
+    void scanTick();                      // une ligne par appel
+    void driveRow(uint8_t r, bool active);
+    bool columnLow(uint8_t c) const;
+    void debounce();
+    void push(char key);
+    bool pop(KeyEvent &ev);
+    void processKey(char key);
 
     void resetBuffer();
-    void beep(uint16_t freq, uint16_t duration);
+    void beep(uint16_t freq, uint16_t duration, BuzzPriority priority);
 };
 
-#endif
\ No newline at end of file
+#endif
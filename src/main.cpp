@@ -2,11 +2,21 @@
 
 #include "fsm/FSMController.h"
 #include "rfid/RFIDModule.h"
+#include "rfid/ReaderScheduler.h"
 #include "eeprom/EEPROMStore.h"
 #include "keypad/KeypadModule.h"
+#include "ui/Buzzer.h"
 #include "ui/UIFeedback.h"
-#include "relay/RelayController.h"
+#include "relay/RelayBank.h"
 #include "comm/JsonComm.h"
+#include "trace/LatencyTrace.h"
+#include "power/PowerManager.h"
+#include "health/HealthSupervisor.h"
+#include "health/MemoryWatch.h"
+#include "schedule/SoftClock.h"
+#include "schedule/AccessSchedule.h"
+#include "audit/AuditLog.h"
+#include "auth/LockoutPolicy.h"
 
 #include "config.h"
 
@@ -17,6 +27,19 @@ const uint8_t LED_GREEN  = 7;
 const uint8_t LED_RED    = 6;
 const uint8_t BUZZER     = 4;
 const uint8_t RELAY_PIN  = 8;
+const uint8_t RFID_IRQ_PIN = 255; // IRQ MFRC522 (255 = non câblée)
+
+#if RELAY_COUNT > 1
+// 2e porte : relais dédié, ouvert par le 2e lecteur
+const uint8_t RELAY2_PIN = 5;
+#endif
+
+#if RFID_READER_COUNT > 1
+// 2e lecteur (sortie / 2e porte) : SS dédié, RST partagé -> non piloté (soft reset)
+const uint8_t SS2_PIN       = 53;
+const uint8_t RST2_PIN      = 255;
+const uint8_t RFID2_IRQ_PIN = 255;
+#endif
 
 /* ===== KEYPAD 4x4 ===== */
 const byte ROWS = 4;
@@ -34,46 +57,384 @@ byte colPins[COLS] = { A4, A5, 2, 3 };
 
 /* ===== MODULES ===== */
 EEPROMStore     eeprom;
-RFIDModule      rfid(SS_PIN, RST_PIN);
-RelayController relay(RELAY_PIN, RELAY_DEFAULT_OPEN_TIME);
-UIFeedback      ui(LED_GREEN, LED_RED, BUZZER);
-KeypadModule    keypad(keys, rowPins, colPins, ROWS, COLS, DEFAULT_ADMIN_PIN, BUZZER);
+RFIDModule      rfid(SS_PIN, RST_PIN, RFID_IRQ_PIN);
+#if RFID_READER_COUNT > 1
+RFIDModule      rfid2(SS2_PIN, RST2_PIN, RFID2_IRQ_PIN);
+RFIDModule     *rfidList[] = { &rfid, &rfid2 };
+#else
+RFIDModule     *rfidList[] = { &rfid };
+#endif
+ReaderScheduler readers(rfidList, RFID_READER_COUNT);
+RelayBank       relays;
+Buzzer          buzzer(BUZZER);   // seul propriétaire de la broche : clavier + UI
+UIFeedback      ui(LED_GREEN, LED_RED, &buzzer);
+KeypadModule    keypad(keys, rowPins, colPins, ROWS, COLS, DEFAULT_ADMIN_PIN, &buzzer);
 JsonComm        comm(Serial);
+PowerManager    power(Serial);
+HealthSupervisor health(eeprom);
+MemoryWatch     memory;
+SoftClock       softClock;
+AccessSchedule  schedule(eeprom, softClock);
+AuditLog        audit(eeprom, softClock);
+LockoutPolicy   lockout(eeprom);
 
 /* ===== FSM ===== */
 FSMController fsm;
 
+#ifdef LATENCY_TRACE_ENABLE
+LatencyTrace    trace;
+#endif
+
+/* ===== COMMANDE SÉRIE EN ATTENTE (buffers fixes, pas de heap) ===== */
+static bool serialCmdReady = false;
+static char serialCmd[CMD_MAX_LEN + 1];
+static char serialCmdId[REQ_ID_MAX_LEN + 1];   // "id" de la requête, "" si absent
+
+// Requête en cours de traitement (takeCommand) : ses réponses reprennent son id,
+// y compris la réponse différée (badge présenté, confirmation de reset)
+static char replyToId[REQ_ID_MAX_LEN + 1];
+
+// Début de la session admin (PIN ou badge admin) en attente de commande
+static unsigned long adminSessionMs = 0;
+
+// Copie v (chaîne ou entier JSON) dans out sans espaces de tête/fin.
+// Retourne false si vide ou trop long.
+static bool copyTrimmedCmd(JsonVariant v, char *out, size_t outSize) {
+    out[0] = '\0';
+    const char *src = v.as<const char*>();
+    char numBuf[12];
+    if (!src) {
+        if (!v.is<long>()) return false;
+        snprintf(numBuf, sizeof(numBuf), "%ld", v.as<long>());
+        src = numBuf;
+    }
+
+    while (*src == ' ' || *src == '\t' || *src == '\r' || *src == '\n') src++;
+    size_t len = strlen(src);
+    while (len > 0 && (src[len - 1] == ' ' || src[len - 1] == '\t' ||
+                       src[len - 1] == '\r' || src[len - 1] == '\n')) len--;
+
+    if (len == 0 || len >= outSize) return false;
+    memcpy(out, src, len);
+    out[len] = '\0';
+    return true;
+}
+
+// Récupère la commande prête (série prioritaire, sinon keypad)
+static bool takeCommand(char *out, size_t outSize, AuthSource *source = nullptr) {
+    if (serialCmdReady) {
+        strncpy(out, serialCmd, outSize - 1);
+        out[outSize - 1] = '\0';
+        serialCmdReady = false;
+        serialCmd[0] = '\0';
+        memcpy(replyToId, serialCmdId, sizeof(replyToId));
+        if (source) *source = AuthSource::SERIAL_LINK;
+        return true;
+    }
+    if (!keypad.isCommandReady()) return false;
+    keypad.getCommand(out, outSize);
+    replyToId[0] = '\0';
+    if (source) *source = AuthSource::KEYPAD;
+    return true;
+}
+
+// Id d'une réponse à la commande en cours : id de la requête série, sinon id local
+static void replyId(char *buf, size_t size) {
+    if (replyToId[0] != '\0') {
+        strncpy(buf, replyToId, size - 1);
+        buf[size - 1] = '\0';
+        return;
+    }
+    comm.generateLocalEventId(buf, size);
+}
+
+// Id d'une réponse de diagnostic : id de la requête, sinon id local (copié)
+static void setReplyId(JsonDocument &doc, const char *id) {
+    if (id && id[0] != '\0') {
+        doc["id"] = id;
+        return;
+    }
+    char evtid[32];
+    comm.generateLocalEventId(evtid, sizeof(evtid));
+    doc["id"] = evtid;
+}
+
+// Supprime toutes les occurrences de c (équivalent String::replace(c, ""))
+static void stripChar(char *s, char c) {
+    char *w = s;
+    for (char *r = s; *r; r++) {
+        if (*r != c) *w++ = *r;
+    }
+    *w = '\0';
+}
+
+// PIN EEPROM -> KeypadModule (boot, reset, changement de PIN uniquement)
+static void syncAdminPIN() {
+    char pin[KeypadModule::MAX_PIN + 1];
+    eeprom.readAdminPIN(pin, sizeof(pin));
+    keypad.changeAdminPIN(pin);
+}
+
+/* ===== BENCHMARK RFID (polling vs IRQ) ===== */
+static void addBenchResult(JsonObject dst, const RFIDStats &b) {
+    dst["polls"] = b.polls;
+    dst["exchanges_per_s"] = (uint32_t)(b.exchanges * 1000UL / RFID_BENCH_MS);
+    dst["us_per_exchange"] = b.exchanges ? b.busyUs / b.exchanges : 0;
+    dst["detections"] = b.detections;
+    dst["detect_latency_us"] = b.detectLatencyUs;
+}
+
+static void sendRfidBench(const char *id) {
+    StaticJsonDocument<256> doc;
+    doc["type"] = "rfid_bench";
+    doc["status"] = "success";
+    doc["duration_ms"] = RFID_BENCH_MS;
+
+    // Mesure sur le lecteur principal (index 0)
+    RFIDStats b;
+    rfid.benchmark(RFIDMode::POLLING, RFID_BENCH_MS, b);
+    addBenchResult(doc.createNestedObject("polling"), b);
+
+    if (rfid.hasIrq()) {
+        rfid.benchmark(RFIDMode::IRQ, RFID_BENCH_MS, b);
+        addBenchResult(doc.createNestedObject("irq"), b);
+    } else {
+        doc["irq"] = "not_wired";
+    }
+
+    setReplyId(doc, id);
+    comm.sendResponse(doc);
+}
+
+/* ===== PROFIL LECTEUR ===== */
+static void applyReaderProfile(uint8_t index) {
+    const ReaderProfile &p = RFIDModule::builtinProfile(index);
+    for (uint8_t i = 0; i < readers.count(); i++) {
+        readers.get(i).applyProfile(p);
+    }
+}
+
+/* ===== CONFIG RUNTIME (section EEPROM, lue une fois au boot) ===== */
+static void applyConfig(const RuntimeConfig &cfg) {
+    for (uint8_t d = 0; d < relays.count(); d++) {
+        relays.setOpenTime(d, cfg.relayOpenMs);
+    }
+    lockout.setPolicy(cfg.maxAttempts, cfg.lockoutSec);
+    applyReaderProfile(cfg.readerProfile < RFIDModule::PROFILE_COUNT ? cfg.readerProfile : RFID_PROFILE_DEFAULT);
+}
+
+static void attachConfig(JsonObject out, const RuntimeConfig &cfg) {
+    out["open_ms"] = cfg.relayOpenMs;
+    out["max_attempts"] = cfg.maxAttempts;
+    out["lockout_s"] = cfg.lockoutSec;
+    out["reader_profile"] = cfg.readerProfile;
+}
+
+static void sendConfig(const char *id) {
+    StaticJsonDocument<192> doc;
+    doc["type"] = "config";
+    doc["status"] = "success";
+    doc["eeprom_version"] = EEPROM_VERSION;
+    attachConfig(doc.createNestedObject("config"), eeprom.getConfig());
+
+    setReplyId(doc, id);
+
+    comm.sendResponse(doc);
+}
+
+// Auto-test : coût par tentative et taux de lecture pour chaque profil
+// (poser une carte sur le lecteur principal avant de lancer)
+static void sendRfidSelfTest(const char *id) {
+    StaticJsonDocument<320> doc;
+    doc["type"] = "rfid_selftest";
+    doc["status"] = "success";
+    doc["duration_ms"] = RFID_SELFTEST_MS;
+
+    JsonArray res = doc.createNestedArray("profiles");
+    for (uint8_t p = 0; p < RFIDModule::PROFILE_COUNT; p++) {
+        RFIDSelfTest t;
+        rfid.selfTest(RFIDModule::builtinProfile(p), RFID_SELFTEST_MS, t);
+
+        JsonObject o = res.createNestedObject();
+        o["profile"] = p;
+        o["attempts"] = t.attempts;
+        o["success_pct"] = t.attempts ? (uint16_t)((uint32_t)t.successes * 100UL / t.attempts) : 0;
+        o["us_per_poll"] = t.usPerAttempt;
+    }
+
+    setReplyId(doc, id);
+    comm.sendResponse(doc);
+}
+
+// Lit exactement n chiffres décimaux à partir de s ; false si autre caractère
+// ou si la valeur dépasse uint32_t (epoch > 4294967295 refusé, pas tronqué)
+static bool parseDigits(const char *s, uint8_t n, uint32_t &out) {
+    out = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9') return false;
+        uint8_t d = s[i] - '0';
+        if (out > (UINT32_MAX - d) / 10) return false;
+        out = out * 10 + d;
+    }
+    return true;
+}
+
+// HHMM -> minutes dans la journée (2400 accepté comme fin de journée)
+static bool parseHHMM(const char *s, uint16_t &minutes) {
+    uint32_t hh, mm;
+    if (!parseDigits(s, 2, hh) || !parseDigits(s + 2, 2, mm)) return false;
+    if (mm > 59 || hh > 24 || (hh == 24 && mm != 0)) return false;
+    minutes = hh * 60 + mm;
+    return true;
+}
+
+/* ===== JOURNAL D'ACCÈS (lecture seule, par blocs, curseur = seq) ===== */
+static void sendAuditChunk(const char *id, const char *cursorStr) {
+    StaticJsonDocument<512> doc;
+    doc["type"] = "audit";
+
+    uint32_t cursor = 0;
+    size_t len = strlen(cursorStr);
+    if (len > 5 || (len > 0 && !parseDigits(cursorStr, len, cursor)) || cursor > 0xFFFF) {
+        comm.sendError(id, "invalid_cursor");
+        return;
+    }
+
+    doc["status"] = "success";
+    // sans curseur : depuis le plus ancien enregistrement conservé
+    audit.attachChunk(doc.as<JsonObject>(), len ? (uint16_t)cursor : audit.oldestSeq());
+
+    setReplyId(doc, id);
+
+    comm.sendResponse(doc);
+}
+
+/* ===== STATS (requête lecture seule, sans auth admin) ===== */
+static void sendMemory(const char *id) {
+    StaticJsonDocument<192> doc;
+    doc["type"] = "mem";
+    doc["status"] = "success";
+    memory.scan();
+    memory.attachStats(doc.as<JsonObject>());
+
+    setReplyId(doc, id);
+
+    comm.sendResponse(doc);
+}
+
+static void sendStats(const char *id) {
+    StaticJsonDocument<640 + 128 * RFID_READER_COUNT> doc;
+    doc["type"] = "stats";
+    doc["status"] = "success";
+
+#ifdef LATENCY_TRACE_ENABLE
+    JsonObject lat = doc.createNestedObject("latency");
+    lat["n"] = trace.sampleCount();
+    lat["p50_us"] = trace.percentile(50);
+    lat["p99_us"] = trace.percentile(99);
+#endif
+
+    JsonObject pwr = doc.createNestedObject("power");
+    pwr["idle_pct"] = power.getIdlePercent();
+    pwr["sleep_ms"] = power.getSleepMs();
+    pwr["wakeups"] = power.getWakeups();
+
+    health.attachStats(doc.createNestedObject("health"));
+
+    JsonArray rl = doc.createNestedArray("rfid");
+    for (uint8_t i = 0; i < readers.count(); i++) {
+        RFIDModule &rd = readers.get(i);
+        const RFIDStats &rs = rd.getStats();
+        JsonObject r = rl.createNestedObject();
+        r["reader"] = i;
+        r["online"] = readers.isOnline(i);
+        r["mode"] = rd.getMode() == RFIDMode::IRQ ? "irq" : "polling";
+        r["exchanges"] = rs.exchanges;
+        r["busy_us"] = rs.busyUs;
+        r["reads"] = rs.detections;
+        r["suppressed"] = rs.suppressed;
+        r["read_errors"] = rs.readErrors;
+        r["detect_latency_us"] = rs.detectLatencyUs;
+    }
+
+    JsonObject uc = doc.createNestedObject("uid_cache");
+    uc["hits"] = eeprom.getCacheHits();
+    uc["misses"] = eeprom.getCacheMisses();
+
+    audit.attachStats(doc.createNestedObject("audit"));
+    lockout.attachStats(doc.createNestedObject("lockout"));
+    keypad.attachStats(doc.createNestedObject("keypad"));
+
+    JsonObject clk = doc.createNestedObject("clock");
+    clk["synced"] = softClock.isSynced();
+    if (softClock.isSynced()) clk["epoch"] = softClock.now();
+
+    setReplyId(doc, id);
+
+    comm.sendResponse(doc);
+}
+
 void setup() {
+    memory.begin();   // avant tout : la zone libre entière est peinte
     Serial.begin(115200);
     DEBUG_PRINTLN(F("\n=== SYSTEM START ==="));
 
     eeprom.begin();
-    rfid.begin();
-    relay.begin();
+    readers.begin();
+    relays.addChannel(RELAY_PIN, RELAY_DEFAULT_OPEN_TIME, RelayMode::PULSE, RELAY_MIN_OFF_MS);
+#if RELAY_COUNT > 1
+    relays.addChannel(RELAY2_PIN, RELAY_DEFAULT_OPEN_TIME, RelayMode::PULSE, RELAY_MIN_OFF_MS);
+#endif
+    relays.begin();
+    buzzer.begin();
     ui.begin();
     keypad.begin();
-    keypad.changeAdminPIN(eeprom.readAdminPIN()); // <-- synchronisation PIN EEPROM / KeypadModule
+    syncAdminPIN(); // <-- synchronisation PIN EEPROM / KeypadModule
+    applyConfig(eeprom.getConfig());
+    lockout.begin();
     comm.begin();
-
+    power.watchFlag(keypad.eventFlag());
+    for (uint8_t i = 0; i < readers.count(); i++) {
+        power.watchFlag(readers.get(i).irqFlag());
+    }
+    power.begin();
+    health.begin();
+    schedule.begin();
+    audit.begin();
+
+    // Cause du dernier reset + compteurs de retard de la session précédente
+    StaticJsonDocument<192> bootDoc;
+    bootDoc["type"] = "boot";
+    health.attachBootReport(bootDoc.as<JsonObject>());
+    char evtid[32];
+    comm.generateLocalEventId(evtid, sizeof(evtid));
+    bootDoc["id"] = evtid;
+    comm.sendResponse(bootDoc);
+
+    memory.mark(LoopStage::SETUP);
     DEBUG_PRINTLN(F("[SETUP] Init complete"));
 }
 
 void loop() {
-    // unchanged logic remains...
-    keypad.update();
-    relay.update();
+    // En idle, RFID n'est scanné qu'à chaque tick (ou sur réveil IRQ) ;
+    // le clavier est scanné sous IRQ, update() ne fait que vider sa file
+    bool scanDue = power.pollDue();
+
+    if (keypad.update()) power.noteActivity();
+    // échéance relais servie en retard (loop() bloquée) : pas de check-in,
+    // le délai du superviseur court depuis le dernier passage à l'heure
+    if (relays.update() < HEALTH_DEADLINE_RELAY_MS) health.checkIn(Subsystem::RELAY);
 
     /* =====================================================
        ETAT PORTE – FEEDBACK TEMPS RÉEL (OUVERT / FERMÉ)
        ===================================================== */
-    static bool lastDoorState = false;
-    bool currentDoorState = relay.isOpen();
-
-    if (currentDoorState != lastDoorState) {
+    RelayEvent relayEvent;
+    while (relays.nextEvent(relayEvent)) {
         StaticJsonDocument<128> doc;
         doc["type"] = "door_state";
+        doc["door"] = relayEvent.channel;
 
-        if (currentDoorState) {
+        if (relayEvent.open) {
             doc["state"] = "opened";
         } else {
             doc["state"] = "closed";
@@ -85,25 +446,45 @@ void loop() {
         doc["id"] = evtid;
 
         comm.sendResponse(doc);
-        lastDoorState = currentDoorState;
     }
+    memory.mark(LoopStage::INPUTS);
 
     /* =====================================================
        SERIAL JSON = SOURCE DE COMMANDE ALTERNATIVE AU KEYPAD
        ===================================================== */
-    static bool serialCmdReady = false;
-    static String serialCmd = "";
-
     if (!serialCmdReady) {
         StaticJsonDocument<256> rxDoc;
 
         if (comm.receiveCommand(rxDoc)) {
-            if (rxDoc.containsKey("cmd")) {
-                serialCmd = rxDoc["cmd"].as<String>();
-                serialCmd.trim();
+            power.noteActivity();
 
-                if (serialCmd.length() > 0) {
+            if (rxDoc.containsKey("cmd")) {
+                const char *id = rxDoc["id"].as<const char*>();
+
+                if (!copyTrimmedCmd(rxDoc["cmd"], serialCmd, sizeof(serialCmd))) {
+                    comm.sendError(id, "invalid_cmd");
+                } else if (strcmp(serialCmd, "stats") == 0) {
+                    // diagnostic : réponse immédiate, ne passe pas par la FSM
+                    sendStats(id);
+                    serialCmd[0] = '\0';
+                } else if (strcmp(serialCmd, "config") == 0) {
+                    sendConfig(id);
+                    serialCmd[0] = '\0';
+                } else if (strcmp(serialCmd, "mem") == 0) {
+                    sendMemory(id);
+                    serialCmd[0] = '\0';
+                } else if (strncmp(serialCmd, "audit", 5) == 0) {
+                    // "audit" ou "audit<seq>" : bloc suivant du journal
+                    sendAuditChunk(id, serialCmd + 5);
+                    serialCmd[0] = '\0';
+                } else {
                     serialCmdReady = true;
+                    // id trop long : tronqué (l'hôte garde des id courts)
+                    serialCmdId[0] = '\0';
+                    if (id) {
+                        strncpy(serialCmdId, id, REQ_ID_MAX_LEN);
+                        serialCmdId[REQ_ID_MAX_LEN] = '\0';
+                    }
                     DEBUG_PRINT(F("[SERIAL CMD READY] "));
                     DEBUG_PRINTLN(serialCmd);
                 }
@@ -115,36 +496,119 @@ void loop() {
         }
     }
 
+    // Progrès du lien : octets reçus tous lus, ou commande tenue pour la FSM
+    // (lecture suspendue volontairement). Flux non vidé : délai qui court.
+    if (serialCmdReady || Serial.available() == 0) health.checkIn(Subsystem::SERIAL_LINK);
+    memory.mark(LoopStage::SERIAL_RX);
+
     /* =====================================================
        DÉTECTION COMMANDE (KEYPAD OU SERIAL)
        ===================================================== */
     if (
         (keypad.isCommandReady() || serialCmdReady) &&
-        fsm.getState() == SystemState::IDLE
+        fsm.getState() == SystemState::IDLE &&
+        fsm.getAction() == FSMAction::NONE    // sinon session admin : c'est la commande
     ) {
         fsm.onCommandDetected();
     }
 
     // Détection badge RFID
-    if (rfid.poll() && rfid.hasNewCard()) {
+    bool cardDetected = false;
+    if (scanDue) {
+        cardDetected = readers.poll() >= 0;
+        health.checkIn(Subsystem::RFID);
+    }
+
+    if (cardDetected) power.noteActivity();
+
+    // En WAIT_ADD/REMOVE_BADGE la carte est consommée plus bas, pas validée
+    if (cardDetected && fsm.getState() == SystemState::IDLE) {
         fsm.onBadgeDetected();
+#ifdef LATENCY_TRACE_ENABLE
+        trace.start(readers.current().getDetectMicros());
+#endif
     }
 
     fsm.update();
+    memory.mark(LoopStage::RFID);
 
     // ==== ACTIONS PRINCIPALES ====
     switch (fsm.getAction()) {
 
         case FSMAction::VALIDATE_BADGE: {
             uint8_t uid[EEPROMStore::UID_SIZE];
-            rfid.getUID(uid);
-            bool ok = eeprom.badgeExists(uid);
+            readers.getUID(uid);
+#ifdef LATENCY_TRACE_ENABLE
+            trace.mark(TraceStage::UID);
+#endif
+            // une seule recherche : slot, rôles et modèle horaire
+            BadgeInfo badge;
+            bool known = eeprom.lookupBadge(uid, badge);
+#ifdef LATENCY_TRACE_ENABLE
+            trace.mark(TraceStage::LOOKUP);
+#endif
+
+            /* ===== BADGE ADMIN : remplace la saisie du PIN ===== */
+            if (known && (badge.roles & EEPROMStore::ROLE_ADMIN)) {
+                audit.log(uid, readers.currentIndex(), AuditDecision::ADMIN_CARD);
+                fsm.onAdminAuthResult(true);
+                adminSessionMs = millis();
+                ui.signal(FeedbackType::ACCESS_GRANTED);
+#ifdef LATENCY_TRACE_ENABLE
+                trace.abort();
+#endif
+
+                StaticJsonDocument<128> doc;
+                doc["status"] = "success";
+                doc["type"] = "admin_auth";
+                doc["access_granted"] = true;
+                doc["method"] = "badge";
+
+                char evtid[32];
+                comm.generateLocalEventId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                break;
+            }
+
+            ScheduleVerdict verdict = ScheduleVerdict::ALLOWED;
+            bool ok = false;
+            if (known && (badge.roles & EEPROMStore::ROLE_SUPERVISOR)) {
+                ok = true;
+            } else if (known && (badge.roles & (EEPROMStore::ROLE_USER | EEPROMStore::ROLE_MAINTENANCE))) {
+                verdict = schedule.check(badge.schedule);
+                if (verdict == ScheduleVerdict::CLOCK_UNSYNCED && (badge.roles & EEPROMStore::ROLE_MAINTENANCE)) {
+                    verdict = ScheduleVerdict::ALLOWED;
+                }
+                ok = verdict == ScheduleVerdict::ALLOWED;
+            }
+
+            // mis en file seulement : l'écriture EEPROM se fait plus tard, par octet
+            AuditDecision decision = AuditDecision::GRANTED;
+            if (!known) decision = AuditDecision::DENIED_UNKNOWN;
+            else if (verdict == ScheduleVerdict::OUTSIDE_WINDOW) decision = AuditDecision::DENIED_SCHEDULE;
+            else if (verdict == ScheduleVerdict::CLOCK_UNSYNCED) decision = AuditDecision::DENIED_CLOCK;
+            else if (!ok) decision = AuditDecision::DENIED_ROLE;
+            audit.log(uid, readers.currentIndex(), decision);
+
+            // action suivante : OPEN_DOOR ou SEND_FEEDBACK
             fsm.onBadgeValidationResult(ok);
 
-            StaticJsonDocument<128> doc;
+            StaticJsonDocument<192> doc;
             doc["status"] = ok ? "success" : "error";
             doc["type"] = "badge";
             doc["access_granted"] = ok;
+            doc["reader"] = readers.currentIndex();
+            if (known) doc["roles"] = badge.roles;
+            if (verdict == ScheduleVerdict::OUTSIDE_WINDOW) doc["reason"] = "outside_schedule";
+            else if (verdict == ScheduleVerdict::CLOCK_UNSYNCED) doc["reason"] = "clock_unsynced";
+            else if (known && !ok) doc["reason"] = "no_role";
+
+#ifdef LATENCY_TRACE_ENABLE
+            if (trace.isActive()) trace.attach(doc.createNestedObject("trace"));
+            if (!ok) trace.abort();
+#endif
 
             // attach generated id
             char evtid[32];
@@ -152,78 +616,115 @@ void loop() {
             doc["id"] = evtid;
 
             comm.sendResponse(doc);
-
-            fsm.clearAction();
             break;
         }
 
         case FSMAction::REQUEST_ADMIN_AUTH: {
-            String cmd;
-
-            if (serialCmdReady) {
-                cmd = serialCmd;
-                serialCmdReady = false;
-                serialCmd = "";
-            } else {
-                if (!keypad.isCommandReady()) break;
-                cmd = keypad.getCommand();
+            char cmd[CMD_MAX_LEN + 1];
+            AuthSource source;
+            if (!takeCommand(cmd, sizeof(cmd), &source)) break;
+
+            // source bloquée : le PIN n'est même pas comparé
+            bool locked = lockout.isLocked(source);
+            bool ok = !locked && keypad.checkAdminPIN(cmd);
+            if (!locked) {
+                if (ok) lockout.onSuccess(source);
+                else lockout.onFailure(source);
             }
+            fsm.onAdminAuthResult(ok); // EXECUTE_COMMAND ou SEND_FEEDBACK
+            if (ok) adminSessionMs = millis();
 
-            keypad.changeAdminPIN(eeprom.readAdminPIN());
-
-            bool ok = keypad.checkAdminPIN(cmd);
-            fsm.onAdminAuthResult(ok);
-
-            StaticJsonDocument<128> doc;
+            StaticJsonDocument<160> doc;
             doc["status"] = ok ? "success" : "error";
             doc["type"] = "admin_auth";
             doc["access_granted"] = ok;
-            if (!ok) doc["locked"] = keypad.isLocked();
+            doc["source"] = source == AuthSource::KEYPAD ? "keypad" : "serial";
+            if (!ok) {
+                unsigned long waitMs = lockout.remainingMs(source);
+                doc["locked"] = waitMs > 0;
+                if (waitMs > 0) doc["retry_in_s"] = (waitMs + 999UL) / 1000UL;
+                else doc["attempts_left"] = lockout.remainingAttempts(source);
+            }
 
             char evtid[32];
-            comm.generateLocalEventId(evtid, sizeof(evtid));
+            replyId(evtid, sizeof(evtid));
             doc["id"] = evtid;
 
             comm.sendResponse(doc);
-
-            fsm.clearAction();
             break;
         }
 
         case FSMAction::EXECUTE_COMMAND: {
-            String cmd;
+            // session admin sans commande : refermée après ADMIN_SESSION_TIMEOUT_MS
+            if (millis() - adminSessionMs >= ADMIN_SESSION_TIMEOUT_MS) {
+                StaticJsonDocument<96> doc;
+                doc["type"] = "admin_auth";
+                doc["status"] = "expired";
 
-            if (serialCmdReady) {
-                cmd = serialCmd;
-                serialCmdReady = false;
-                serialCmd = "";
-            } else {
-                if (!keypad.isCommandReady()) break;
-                cmd = keypad.getCommand();
+                char evtid[32];
+                comm.generateLocalEventId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+                break;
             }
 
-            cmd.replace("#", "");
+            char cmd[CMD_MAX_LEN + 1];
+            if (!takeCommand(cmd, sizeof(cmd))) break;
+
+            stripChar(cmd, '#');
 
             StaticJsonDocument<256> doc;
             doc["type"] = "command";
 
-            /* ===== OUVERTURE MANUELLE PORTE ===== */
-            if (cmd == "10") {
-                relay.open();
-                ui.signal(FeedbackType::ACCESS_GRANTED);
+            /* ===== OUVERTURE MANUELLE PORTE : 10 (porte 0) ou 10<n> ===== */
+            if (strncmp(cmd, "10", 2) == 0 && strlen(cmd) <= 3) {
+                uint8_t door = cmd[2] ? cmd[2] - '0' : 0;
+                if (door < relays.count()) {
+                    relays.open(door);
+                    audit.log(nullptr, door, AuditDecision::MANUAL_OPEN);
+                    ui.signal(FeedbackType::ACCESS_GRANTED);
+
+                    doc["status"] = "success";
+                    doc["action"] = "open_door";
+                    doc["door"] = door;
+                } else {
+                    ui.signal(FeedbackType::ERROR);
+                    doc["status"] = "error";
+                    doc["message"] = "Unknown door";
+                }
 
-                doc["status"] = "success";
-                doc["action"] = "open_door";
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+            }
+
+            /* ===== FERMETURE FORCÉE (mode LATCH) : 15<n> ===== */
+            else if (strncmp(cmd, "15", 2) == 0 && strlen(cmd) == 3) {
+                uint8_t door = cmd[2] - '0';
+                if (door < relays.count()) {
+                    relays.close(door);
+                    doc["status"] = "success";
+                    doc["action"] = "close_door";
+                    doc["door"] = door;
+                } else {
+                    doc["status"] = "error";
+                    doc["message"] = "Unknown door";
+                }
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
 
                 comm.sendResponse(doc);
                 fsm.onExecutionDone();
             }
 
-            else if (cmd == "11") {
+            else if (strcmp(cmd, "11") == 0) {
                 ui.signal(FeedbackType::SCAN_BADGE);
                 fsm.setState(SystemState::WAIT_ADD_BADGE);
                 fsm.clearAction();
@@ -231,10 +732,10 @@ void loop() {
                 doc["command"] = "add_badge";
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
                 comm.sendResponse(doc);
-            } else if (cmd == "12") {
+            } else if (strcmp(cmd, "12") == 0) {
                 ui.signal(FeedbackType::SCAN_BADGE);
                 fsm.setState(SystemState::WAIT_REMOVE_BADGE);
                 fsm.clearAction();
@@ -242,11 +743,11 @@ void loop() {
                 doc["command"] = "remove_badge";
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
                 comm.sendResponse(doc);
 
-            } else if (cmd == "13") {
+            } else if (strcmp(cmd, "13") == 0) {
                 doc["status"] = "success";
                 doc["total_badges"] = eeprom.getBadgeCount();
                 JsonArray badges = doc.createNestedArray("badges");
@@ -263,26 +764,191 @@ void loop() {
                 }
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
 
                 comm.sendResponse(doc);
                 fsm.onExecutionDone();
 
-            } else if (cmd == "14") {
+            } else if (strncmp(cmd, "20", 2) == 0 && strlen(cmd) == 3) {
+                /* ===== PROFIL LECTEUR : 20<n> ===== */
+                uint8_t index = cmd[2] - '0';
+                if (index < RFIDModule::PROFILE_COUNT) {
+                    RuntimeConfig cfg = eeprom.getConfig();
+                    cfg.readerProfile = index;
+                    eeprom.setConfig(cfg);
+                    applyReaderProfile(index);
+                    ui.signal(FeedbackType::ACCESS_GRANTED);
+                    doc["status"] = "success";
+                    doc["reader_profile"] = index;
+                } else {
+                    ui.signal(FeedbackType::ERROR);
+                    doc["status"] = "error";
+                    doc["message"] = "Unknown reader profile";
+                }
+
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+
+            } else if (strncmp(cmd, "40", 2) == 0 && strlen(cmd) >= 4) {
+                /* ===== CONFIG : 40<champ><valeur> ===== */
+                // 1 = ouverture (ms), 2 = essais PIN, 3 = 1er blocage (s), 4 = profil lecteur
+                RuntimeConfig cfg = eeprom.getConfig();
+                uint32_t value;
+                size_t digits = strlen(cmd + 3);
+                bool ok = digits <= 5 && parseDigits(cmd + 3, digits, value);
+                if (ok) {
+                    switch (cmd[2]) {
+                        case '1': ok = value >= 100 && value <= 60000; cfg.relayOpenMs = value; break;
+                        case '2': ok = value >= 1 && value <= 20; cfg.maxAttempts = value; break;
+                        case '3': ok = value >= 1 && value <= LOCKOUT_MAX_SEC; cfg.lockoutSec = value; break;
+                        case '4': ok = value < RFIDModule::PROFILE_COUNT; cfg.readerProfile = value; break;
+                        default: ok = false; break;
+                    }
+                }
+
+                if (ok) {
+                    eeprom.setConfig(cfg);
+                    applyConfig(cfg);
+                    ui.signal(FeedbackType::ACCESS_GRANTED);
+                    doc["status"] = "success";
+                    attachConfig(doc.createNestedObject("config"), cfg);
+                } else {
+                    ui.signal(FeedbackType::ERROR);
+                    doc["status"] = "error";
+                    doc["message"] = "Invalid config field or value";
+                }
+
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+
+            } else if (strncmp(cmd, "30", 2) == 0 && strlen(cmd) == 12) {
+                /* ===== SYNCHRO HORLOGE : 30<epoch local, 10 chiffres> ===== */
+                uint32_t epoch;
+                if (parseDigits(cmd + 2, 10, epoch)) {
+                    softClock.setEpoch(epoch);
+                    doc["status"] = "success";
+                    doc["epoch"] = epoch;
+                } else {
+                    doc["status"] = "error";
+                    doc["message"] = "Invalid epoch";
+                }
+
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+
+            } else if (strncmp(cmd, "31", 2) == 0 && strlen(cmd) == 5) {
+                /* ===== MODÈLE D'UN BADGE : 31<slot 2 chiffres><modèle> ===== */
+                uint32_t slot, tpl;
+                if (parseDigits(cmd + 2, 2, slot) && parseDigits(cmd + 4, 1, tpl) &&
+                    eeprom.setBadgeSchedule(slot, tpl)) {
+                    ui.signal(FeedbackType::ACCESS_GRANTED);
+                    doc["status"] = "success";
+                    doc["slot"] = slot;
+                    doc["schedule"] = tpl;
+                } else {
+                    ui.signal(FeedbackType::ERROR);
+                    doc["status"] = "error";
+                    doc["message"] = "Invalid slot or schedule";
+                }
+
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+
+            } else if (strncmp(cmd, "32", 2) == 0 && strlen(cmd) == 14) {
+                /* ===== PLAGE HORAIRE : 32<modèle><jours 3 chiffres><HHMM début><HHMM fin> ===== */
+                uint32_t tpl, days;
+                uint16_t startMin, endMin;
+                if (parseDigits(cmd + 2, 1, tpl) && parseDigits(cmd + 3, 3, days) &&
+                    parseHHMM(cmd + 6, startMin) && parseHHMM(cmd + 10, endMin) &&
+                    schedule.addWindow(tpl, days, startMin, endMin)) {
+                    ui.signal(FeedbackType::ACCESS_GRANTED);
+                    doc["status"] = "success";
+                    doc["schedule"] = tpl;
+                } else {
+                    ui.signal(FeedbackType::ERROR);
+                    doc["status"] = "error";
+                    doc["message"] = "Invalid schedule window";
+                }
+
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+
+            } else if (strncmp(cmd, "33", 2) == 0 && strlen(cmd) == 3) {
+                /* ===== EFFACER UN MODÈLE : 33<modèle> ===== */
+                uint32_t tpl;
+                if (parseDigits(cmd + 2, 1, tpl) && schedule.clear(tpl)) {
+                    doc["status"] = "success";
+                    doc["schedule"] = tpl;
+                } else {
+                    doc["status"] = "error";
+                    doc["message"] = "Unknown schedule";
+                }
+
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+
+            } else if (strncmp(cmd, "34", 2) == 0 && strlen(cmd) == 6) {
+                /* ===== RÔLES D'UN BADGE : 34<slot 2 chiffres><rôles 2 chiffres> ===== */
+                uint32_t slot, roles;
+                if (parseDigits(cmd + 2, 2, slot) && parseDigits(cmd + 4, 2, roles) &&
+                    roles <= EEPROMStore::ROLE_MASK && eeprom.setBadgeRoles(slot, roles)) {
+                    ui.signal(FeedbackType::ACCESS_GRANTED);
+                    doc["status"] = "success";
+                    doc["slot"] = slot;
+                    doc["roles"] = roles;
+                } else {
+                    ui.signal(FeedbackType::ERROR);
+                    doc["status"] = "error";
+                    doc["message"] = "Invalid slot or roles";
+                }
+
+                char evtid[32];
+                replyId(evtid, sizeof(evtid));
+                doc["id"] = evtid;
+
+                comm.sendResponse(doc);
+                fsm.onExecutionDone();
+
+            } else if (strcmp(cmd, "14") == 0) {
                 ui.signal(FeedbackType::CONFIRM_RESET);
                 fsm.setState(SystemState::WAIT_RESET_CONFIRM);
                 fsm.clearAction();
                 doc["status"] = "confirm_reset";
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
                 comm.sendResponse(doc);
 
-            } else if (cmd.startsWith("99")) {
-                String newPin = cmd.substring(2);
-                if (newPin.length() >= 3 && newPin.length() <= 6) {
+            } else if (strncmp(cmd, "99", 2) == 0) {
+                const char *newPin = cmd + 2;
+                size_t pinLen = strlen(newPin);
+                if (pinLen >= 3 && pinLen <= 6) {
                     if (keypad.changeAdminPIN(newPin)) {
                         eeprom.writeAdminPIN(newPin);
                         ui.signal(FeedbackType::ACCESS_GRANTED);
@@ -299,19 +965,28 @@ void loop() {
                     doc["message"] = "PIN length must be 3-6 digits";
                 }
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
 
                 comm.sendResponse(doc);
                 fsm.onExecutionDone();
 
+            } else if (strcmp(cmd, "rfid_bench") == 0) {
+                /* ===== DIAGNOSTIC RFID (loop() bloquée ~1 s) : session admin requise ===== */
+                sendRfidBench(replyToId);
+                fsm.onExecutionDone();
+
+            } else if (strcmp(cmd, "rfid_selftest") == 0) {
+                sendRfidSelfTest(replyToId);
+                fsm.onExecutionDone();
+
             } else {
                 ui.signal(FeedbackType::ERROR);
                 doc["status"] = "error";
                 doc["message"] = "Unknown command";
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
 
                 comm.sendResponse(doc);
@@ -322,12 +997,28 @@ void loop() {
         }
 
         case FSMAction::OPEN_DOOR: {
-            relay.open();
+#ifdef LATENCY_TRACE_ENABLE
+            trace.mark(TraceStage::OPEN_DOOR);
+#endif
+            // lecteur i -> porte i (lecteurs en surnombre : porte 0)
+            uint8_t door = readers.currentIndex() < relays.count() ? readers.currentIndex() : 0;
+            relays.open(door);
+#ifdef LATENCY_TRACE_ENABLE
+            trace.mark(TraceStage::RELAY);
+#endif
             ui.signal(FeedbackType::ACCESS_GRANTED);
 
-            StaticJsonDocument<128> doc;
+            StaticJsonDocument<192> doc;
             doc["status"] = "success";
             doc["action"] = "open_door";
+            doc["door"] = door;
+
+#ifdef LATENCY_TRACE_ENABLE
+            if (trace.isActive()) {
+                trace.attach(doc.createNestedObject("trace"));
+                trace.finish();
+            }
+#endif
 
             char evtid[32];
             comm.generateLocalEventId(evtid, sizeof(evtid));
@@ -359,14 +1050,15 @@ void loop() {
         default:
             break;
     }
+    memory.mark(LoopStage::ACTION);
 
     // ==== ETATS WAIT_* ====
     switch (fsm.getState()) {
 
         case SystemState::WAIT_ADD_BADGE: {
-            if (rfid.hasNewCard()) {
+            if (readers.hasNewCard()) {
                 uint8_t uid[EEPROMStore::UID_SIZE];
-                rfid.getUID(uid);
+                readers.getUID(uid);
 
                 bool ok = eeprom.addBadge(uid);
                 ui.signal(ok ? FeedbackType::BADGE_ADDED : FeedbackType::ERROR);
@@ -376,21 +1068,21 @@ void loop() {
                 doc["type"] = "add_badge";
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
 
                 comm.sendResponse(doc);
 
-                rfid.halt();
+                readers.halt();
                 fsm.onExecutionDone();
             }
             break;
         }
 
         case SystemState::WAIT_REMOVE_BADGE: {
-            if (rfid.hasNewCard()) {
+            if (readers.hasNewCard()) {
                 uint8_t uid[EEPROMStore::UID_SIZE];
-                rfid.getUID(uid);
+                readers.getUID(uid);
 
                 bool ok = eeprom.removeBadge(uid);
                 ui.signal(ok ? FeedbackType::BADGE_DELETED : FeedbackType::ERROR);
@@ -400,41 +1092,33 @@ void loop() {
                 doc["type"] = "remove_badge";
 
                 char evtid[32];
-                comm.generateLocalEventId(evtid, sizeof(evtid));
+                replyId(evtid, sizeof(evtid));
                 doc["id"] = evtid;
 
                 comm.sendResponse(doc);
 
-                rfid.halt();
+                readers.halt();
                 fsm.onExecutionDone();
             }
             break;
         }
 
         case SystemState::WAIT_RESET_CONFIRM: {
-            String cmd;
-
-            if (serialCmdReady) {
-                cmd = serialCmd;
-                serialCmdReady = false;
-                serialCmd = "";
-            } else {
-                if (!keypad.isCommandReady()) break;
-                cmd = keypad.getCommand();
-            }
+            char cmd[CMD_MAX_LEN + 1];
+            if (!takeCommand(cmd, sizeof(cmd))) break;
 
-            cmd.replace("#", "");
+            stripChar(cmd, '#');
 
             StaticJsonDocument<128> doc;
             doc["type"] = "reset";
 
-            if (cmd == "99") {
+            if (strcmp(cmd, "99") == 0) {
                 eeprom.reset();
-                keypad.changeAdminPIN(eeprom.readAdminPIN());
+                syncAdminPIN();
                 ui.signal(FeedbackType::RESET_DONE);
                 doc["status"] = "success";
                 doc["message"] = "EEPROM reset done";
-            } else if (cmd == "00") {
+            } else if (strcmp(cmd, "00") == 0) {
                 ui.signal(FeedbackType::CANCELLED);
                 doc["status"] = "cancelled";
                 doc["message"] = "Reset cancelled";
@@ -445,7 +1129,7 @@ void loop() {
             }
 
             char evtid[32];
-            comm.generateLocalEventId(evtid, sizeof(evtid));
+            replyId(evtid, sizeof(evtid));
             doc["id"] = evtid;
 
             comm.sendResponse(doc);
@@ -456,4 +1140,23 @@ void loop() {
         default:
             break;
     }
+    memory.mark(LoopStage::WAIT_STATE);
+
+    /* =====================================================
+       IDLE BASSE CONSOMMATION
+       ===================================================== */
+    if (relays.isBusy() ||
+        serialCmdReady || keypad.isCommandReady() ||
+        fsm.getState() != SystemState::IDLE ||
+        fsm.getAction() != FSMAction::NONE) {
+        power.noteActivity();
+    }
+
+    softClock.update();
+    audit.update();
+    health.update();
+    // écriture de journal en cours : sommeil court, un octet EEPROM ~3,3 ms
+    power.sleepIfIdle(audit.isIdle() ? 0 : 4);
+    memory.mark(LoopStage::HOUSEKEEPING);
+    memory.update();
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "PowerManager.h"
+
+#if defined(ARDUINO_ARCH_AVR)
+#include <avr/sleep.h>
+#endif
+
+PowerManager::PowerManager(Stream &serialPort)
+    : serial(serialPort),
+      watchedCount(0),
+      lastActivityMs(0),
+      lastPollMs(0),
+      startMs(0),
+      sleepMs(0),
+      sleepUsRemainder(0),
+      wakeups(0)
+{
+}
+
+void PowerManager::begin() {
+    startMs = millis();
+    lastActivityMs = startMs;
+    lastPollMs = startMs;
+
+    DEBUG_PRINTLN(F("[POWER] Gestion idle prête"));
+}
+
+void PowerManager::watchFlag(volatile bool *flag) {
+    if (!flag || watchedCount >= MAX_WATCHED_FLAGS) return;
+    watched[watchedCount++] = flag;
+}
+
+void PowerManager::noteActivity() {
+    lastActivityMs = millis();
+}
+
+bool PowerManager::isActive() const {
+#ifndef POWER_IDLE_ENABLE
+    return true; // idle désactivé : toujours pleine vitesse
+#endif
+    return (millis() - lastActivityMs) < POWER_ACTIVE_HOLD_MS;
+}
+
+bool PowerManager::pollDue() {
+    unsigned long now = millis();
+
+    if (isActive() || wakePending()) {
+        lastPollMs = now;
+        return true;
+    }
+
+    if ((now - lastPollMs) >= POWER_IDLE_POLL_MS) {
+        lastPollMs = now;
+        return true;
+    }
+    return false;
+}
+
+void PowerManager::sleepIfIdle(unsigned long maxSleepMs) {
+    if (isActive()) return;
+
+    unsigned long start = millis();
+    unsigned long budget = POWER_IDLE_POLL_MS - (start - lastPollMs);
+    if ((start - lastPollMs) >= POWER_IDLE_POLL_MS) budget = 0;
+    if (maxSleepMs > 0 && maxSleepMs < budget) budget = maxSleepMs;
+    if (budget == 0) return;
+
+    unsigned long t0 = micros();
+    // Chaque tick Timer0 (~1 ms) réveille le CPU : on se rendort tant que
+    // rien ne s'est produit et que l'échéance n'est pas atteinte.
+    while (!wakePending() && serial.available() == 0 && (millis() - start) < budget) {
+        enterSleep();
+    }
+
+    unsigned long slept = micros() - t0;
+    sleepUsRemainder += slept % 1000;
+    sleepMs += slept / 1000 + sleepUsRemainder / 1000;
+    sleepUsRemainder %= 1000;
+
+    if (wakePending() || serial.available() > 0) {
+        wakeups++;
+        noteActivity();
+    }
+}
+
+uint8_t PowerManager::getIdlePercent() const {
+    unsigned long total = millis() - startMs;
+    if (total < 100UL) return 0;
+    // total / 100 plutôt que sleepMs * 100 : pas de débordement après ~12 h
+    unsigned long pct = sleepMs / (total / 100UL);
+    return pct > 100 ? 100 : (uint8_t)pct;
+}
+
+unsigned long PowerManager::getSleepMs() const {
+    return sleepMs;
+}
+
+uint32_t PowerManager::getWakeups() const {
+    return wakeups;
+}
+
+/* ===== PRIVATE ===== */
+
+bool PowerManager::wakePending() const {
+    for (uint8_t i = 0; i < watchedCount; i++) {
+        if (*watched[i]) return true;
+    }
+    return false;
+}
+
+void PowerManager::enterSleep() {
+#if defined(ARDUINO_ARCH_AVR)
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    noInterrupts();
+    if (wakePending()) {
+        interrupts();
+        return;
+    }
+    sleep_enable();
+    interrupts();   // sei suivi de sleep : aucune IRQ perdue entre les deux
+    sleep_cpu();
+    sleep_disable();
+#else
+    delay(1);   // pas de sleep matériel (build natif) : attente d'un tick Timer0
+#endif
+}
@@ -0,0 +1,63 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+/*
+  PowerManager
+  - Active : loop() tourne à pleine vitesse (clavier + RFID à chaque passage)
+  - Idle   : après POWER_ACTIVE_HOLD_MS sans activité, le MCU dort (SLEEP_MODE_IDLE)
+             entre deux ticks de scan (POWER_IDLE_POLL_MS).
+  - Réveil immédiat sur :
+      * drapeau d'IRQ surveillé (ex. IRQ MFRC522 gérée par RFIDModule, appui
+        clavier : le scan tourne sur Timer0, actif pendant le sommeil)
+      * octet reçu sur le port série (l'UART reste actif en SLEEP_MODE_IDLE)
+      * échéance passée par l'appelant (ex. fermeture auto du relais)
+  - Le mode IDLE garde Timer0 actif : millis() reste exact, pas de correction à faire.
+  - Rapport : temps dormi / temps total (duty cycle) et nombre de réveils.
+*/
+
+class PowerManager {
+public:
+    static const uint8_t MAX_WATCHED_FLAGS = RFID_MAX_READERS + 1; // lecteurs + clavier
+
+    PowerManager(Stream &serialPort);
+
+    void begin();
+
+    // Drapeau positionné par une ISR d'un autre module : réveille le MCU et force un scan
+    void watchFlag(volatile bool *flag);
+
+    void noteActivity();           // carte, touche, commande série, porte ouverte...
+    bool isActive() const;         // dans la fenêtre d'activité
+
+    // true si le scan clavier/RFID doit être fait à ce passage de loop()
+    bool pollDue();
+
+    // Fin de loop() : dort si inactif, au plus maxSleepMs (0 = jusqu'au prochain tick)
+    void sleepIfIdle(unsigned long maxSleepMs = 0);
+
+    uint8_t getIdlePercent() const;
+    unsigned long getSleepMs() const;
+    uint32_t getWakeups() const;
+
+private:
+    Stream &serial;
+
+    volatile bool *watched[MAX_WATCHED_FLAGS];
+    uint8_t watchedCount;
+
+    unsigned long lastActivityMs;
+    unsigned long lastPollMs;
+    unsigned long startMs;
+
+    unsigned long sleepMs;         // cumul du temps dormi
+    unsigned long sleepUsRemainder;
+    uint32_t wakeups;
+
+    bool wakePending() const;
+    void enterSleep();
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,173 @@
+#include "RelayBank.h"
+
+#ifndef DEBUG_PRINTLN
+#define DEBUG_PRINTLN(x) Serial.println(x)
+#define DEBUG_PRINT(x) Serial.print(x)
+#endif
+
+RelayBank::RelayBank()
+    : n(0),
+      scheduled(0),
+      evHead(0),
+      evCount(0)
+{
+}
+
+int8_t RelayBank::addChannel(uint8_t pin, unsigned long openMs, RelayMode mode, unsigned long minOffMs) {
+    if (n >= RELAY_MAX_CHANNELS) return -1;
+
+    Channel &c = channels[n];
+    c.pin = pin;
+    c.mode = mode;
+    c.open = false;
+    c.pendingOpen = false;
+    c.openMs = openMs;
+    c.minOffMs = minOffMs;
+    c.lastCloseMs = 0;
+    c.deadline = 0;
+    return n++;
+}
+
+void RelayBank::begin() {
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < n; i++) {
+        pinMode(channels[i].pin, OUTPUT);
+        digitalWrite(channels[i].pin, LOW);
+        channels[i].open = false;
+        // pas d'attente minOff au démarrage
+        channels[i].lastCloseMs = now - channels[i].minOffMs;
+    }
+}
+
+unsigned long RelayBank::update() {
+    unsigned long now = millis();
+    unsigned long worstLate = 0;
+
+    // tête de liste seulement : rien d'échu -> une comparaison
+    while (scheduled > 0 && (long)(now - channels[order[0]].deadline) >= 0) {
+        uint8_t ch = order[0];
+        if (now - channels[ch].deadline > worstLate) worstLate = now - channels[ch].deadline;
+        unschedule(ch);
+
+        Channel &c = channels[ch];
+        if (c.pendingOpen) {
+            c.pendingOpen = false;
+            open(ch);
+        } else if (c.open) {
+            drive(ch, false);
+            DEBUG_PRINTLN(F("[RELAY] Auto-closed"));
+        }
+    }
+    return worstLate;
+}
+
+bool RelayBank::open(uint8_t ch) {
+    if (ch >= n) return false;
+    Channel &c = channels[ch];
+    unsigned long now = millis();
+
+    if (c.open) {
+        if (c.mode == RelayMode::PULSE) schedule(ch, now + c.openMs);
+        return true;
+    }
+    if (c.pendingOpen) return true;
+
+    if ((now - c.lastCloseMs) < c.minOffMs) {
+        c.pendingOpen = true;
+        schedule(ch, c.lastCloseMs + c.minOffMs);
+        DEBUG_PRINTLN(F("[RELAY] Open deferred (min off)"));
+        return true;
+    }
+
+    drive(ch, true);
+    if (c.mode == RelayMode::PULSE) schedule(ch, now + c.openMs);
+    DEBUG_PRINTLN(F("[RELAY] Opened"));
+    return true;
+}
+
+bool RelayBank::close(uint8_t ch) {
+    if (ch >= n) return false;
+    Channel &c = channels[ch];
+
+    unschedule(ch);
+    c.pendingOpen = false;
+    if (c.open) {
+        drive(ch, false);
+        DEBUG_PRINTLN(F("[RELAY] Closed"));
+    }
+    return true;
+}
+
+bool RelayBank::isOpen(uint8_t ch) const {
+    return ch < n && channels[ch].open;
+}
+
+bool RelayBank::isBusy() const {
+    for (uint8_t i = 0; i < n; i++) {
+        if (channels[i].open || channels[i].pendingOpen) return true;
+    }
+    return false;
+}
+
+void RelayBank::setOpenTime(uint8_t ch, unsigned long openMs) {
+    if (ch < n) channels[ch].openMs = openMs;
+}
+
+uint8_t RelayBank::count() const {
+    return n;
+}
+
+bool RelayBank::nextEvent(RelayEvent &ev) {
+    if (evCount == 0) return false;
+    ev = events[evHead];
+    evHead = (evHead + 1) % EVENT_QUEUE_SIZE;
+    evCount--;
+    return true;
+}
+
+/* ----- interne ----- */
+
+void RelayBank::drive(uint8_t ch, bool on) {
+    Channel &c = channels[ch];
+    digitalWrite(c.pin, on ? HIGH : LOW);
+    c.open = on;
+    if (!on) c.lastCloseMs = millis();
+    pushEvent(ch, on);
+}
+
+void RelayBank::schedule(uint8_t ch, unsigned long deadline) {
+    unschedule(ch);
+    channels[ch].deadline = deadline;
+
+    // insertion triée (N <= RELAY_MAX_CHANNELS) ; comparaison relative à
+    // maintenant pour rester correcte au rebouclage de millis()
+    unsigned long now = millis();
+    uint8_t pos = scheduled;
+    while (pos > 0 && (long)(deadline - now) < (long)(channels[order[pos - 1]].deadline - now)) {
+        order[pos] = order[pos - 1];
+        pos--;
+    }
+    order[pos] = ch;
+    scheduled++;
+}
+
+void RelayBank::unschedule(uint8_t ch) {
+    for (uint8_t i = 0; i < scheduled; i++) {
+        if (order[i] != ch) continue;
+        for (uint8_t j = i + 1; j < scheduled; j++) order[j - 1] = order[j];
+        scheduled--;
+        return;
+    }
+}
+
+void RelayBank::pushEvent(uint8_t ch, bool open) {
+    if (evCount >= EVENT_QUEUE_SIZE) {
+        // file pleine : l'état le plus ancien est écrasé, le dernier reste juste
+        evHead = (evHead + 1) % EVENT_QUEUE_SIZE;
+        evCount--;
+    }
+    RelayEvent &ev = events[(evHead + evCount) % EVENT_QUEUE_SIZE];
+    ev.channel = ch;
+    ev.open = open;
+    evCount++;
+}
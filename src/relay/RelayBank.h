@@ -0,0 +1,82 @@
+#ifndef RELAY_BANK_H
+#define RELAY_BANK_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+/*
+  RelayBank
+  - N sorties relais (une par porte), chacune avec sa durée d'ouverture,
+    son mode et son intervalle minimal fermé
+      PULSE : refermeture automatique après openMs
+      LATCH : reste ouvert jusqu'à close()
+  - minOffMs : une ouverture demandée trop tôt après une fermeture est
+    différée (protection gâche / serrure), pas refusée
+  - Une seule liste d'échéances triée (fermetures + ouvertures différées) :
+    update() ne regarde que la tête, O(1) par loop() quand rien n'est échu
+  - Changements d'état publiés dans une file d'événements (nextEvent),
+    plus de comparaison d'état à faire côté main.cpp
+*/
+
+enum class RelayMode : uint8_t {
+    PULSE,
+    LATCH
+};
+
+struct RelayEvent {
+    uint8_t channel;
+    bool open;
+};
+
+class RelayBank {
+public:
+    RelayBank();
+
+    // Avant begin(). Renvoie l'index du canal, -1 si RELAY_MAX_CHANNELS atteint
+    int8_t addChannel(uint8_t pin, unsigned long openMs, RelayMode mode, unsigned long minOffMs);
+
+    void begin();
+    unsigned long update();    // retard (ms) de la pire échéance servie, 0 si aucune
+
+    bool open(uint8_t ch);     // PULSE déjà ouvert : prolonge la durée
+    bool close(uint8_t ch);    // annule aussi une ouverture différée
+    bool isOpen(uint8_t ch) const;
+    bool isBusy() const;       // un canal ouvert ou une ouverture en attente
+
+    void setOpenTime(uint8_t ch, unsigned long openMs);
+    uint8_t count() const;
+
+    bool nextEvent(RelayEvent &ev);
+
+private:
+    struct Channel {
+        uint8_t pin;
+        RelayMode mode;
+        bool open;
+        bool pendingOpen;
+        unsigned long openMs;
+        unsigned long minOffMs;
+        unsigned long lastCloseMs;
+        unsigned long deadline;
+    };
+
+    static const uint8_t EVENT_QUEUE_SIZE = 2 * RELAY_MAX_CHANNELS;
+
+    Channel channels[RELAY_MAX_CHANNELS];
+    uint8_t n;
+
+    // canaux avec échéance, triés par échéance croissante
+    uint8_t order[RELAY_MAX_CHANNELS];
+    uint8_t scheduled;
+
+    RelayEvent events[EVENT_QUEUE_SIZE];
+    uint8_t evHead;
+    uint8_t evCount;
+
+    void drive(uint8_t ch, bool on);
+    void schedule(uint8_t ch, unsigned long deadline);
+    void unschedule(uint8_t ch);
+    void pushEvent(uint8_t ch, bool open);
+};
+
+#endif // RELAY_BANK_H
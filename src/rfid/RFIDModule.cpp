@@ -1,40 +1,188 @@
 #include "RFIDModule.h"
-#include "../config.h"
+#include "../trace/InputTrace.h"
 
+RFIDModule *RFIDModule::irqOwners[RFID_MAX_IRQ_READERS] = { nullptr };
 
-RFIDModule::RFIDModule(uint8_t ssPin, uint8_t rstPin)
+// Une ISR statique par emplacement d'irqOwners (attachInterrupt n'a pas de contexte)
+void (*const RFIDModule::irqTrampolines[])() = {
+    RFIDModule::irqTrampoline0,
+    RFIDModule::irqTrampoline1,
+};
+
+static const ReaderProfile PROFILES[RFIDModule::PROFILE_COUNT] = {
+    { MFRC522::RxGain_33dB,  2, 0 },  // rapide  : gain par défaut, REQA sans réponse = 2 ms
+    { MFRC522::RxGain_38dB,  8, 1 },  // équilibré
+    { MFRC522::RxGain_48dB, 25, 2 },  // portée  : gain max, timeout d'origine de la lib
+};
+
+RFIDModule::RFIDModule(uint8_t ssPin, uint8_t rstPin, uint8_t irqPinIn)
     : mfrc522(ssPin, rstPin),
+      ssPin(ssPin),
+      irqPin(irqPinIn),
+      mode(RFIDMode::POLLING),
       cardAvailable(false),
-      cardPreviouslyPresent(false)
+      cardPresent(false),
+      lastSeenMs(0),
+      lastActivityMs(0),
+      lastPollMs(0),
+      pollFastMs(RFID_POLL_FAST_MS),
+      pollSlowMs(RFID_POLL_SLOW_MS),
+      detectUs(0),
+      irqFired(false),
+      irqAtUs(0),
+      lastArmMs(0)
 {
+    memset(uid, 0, sizeof(uid));
+    memset(&stats, 0, sizeof(stats));
+    profile = PROFILES[RFID_PROFILE_DEFAULT];
 }
 
 void RFIDModule::begin() {
     DEBUG_PRINTLN(F("[RFID] Initialisation SPI + MFRC522"));
     SPI.begin();
     mfrc522.PCD_Init();
+    applyProfile(profile);
+
+    if (hasIrq()) {
+        // Une ISR statique par lecteur : retrouver l'instance depuis l'interruption
+        static_assert(sizeof(irqTrampolines) / sizeof(irqTrampolines[0]) >= RFID_MAX_IRQ_READERS,
+                      "RFID_MAX_IRQ_READERS > nombre de trampolines IRQ : en ajouter un");
+        void (*isr)() = nullptr;
+        for (uint8_t i = 0; i < RFID_MAX_IRQ_READERS; i++) {
+            if (irqOwners[i] == nullptr || irqOwners[i] == this) {
+                irqOwners[i] = this;
+                isr = irqTrampolines[i];
+                break;
+            }
+        }
+
+        if (isr) {
+            pinMode(irqPin, INPUT_PULLUP);
+            enableIrqOutput();
+            attachInterrupt(digitalPinToInterrupt(irqPin), isr, FALLING);
+            mode = RFIDMode::IRQ;
+            armReception();
+            DEBUG_PRINTLN(F("[RFID] Mode IRQ"));
+        } else {
+            irqPin = 255;
+        }
+    }
+
     DEBUG_PRINTLN(F("[RFID] Module prêt"));
 }
 
 bool RFIDModule::poll() {
+    unsigned long t0 = micros();
+    stats.polls++;
+
+    bool detected = (mode == RFIDMode::IRQ) ? pollIrq() : pollClassic();
+    if (detected) INPUT_TRACE_UID(ssPin, uid, UID_SIZE);
+
+    stats.busyUs += micros() - t0;
+    return detected;
+}
+
+bool RFIDModule::pollClassic() {
+    cardAvailable = false;
+
+    // Cadence adaptative : rapide juste après une activité, lente au repos
+    unsigned long now = millis();
+    uint16_t interval = (now - lastActivityMs) < RFID_ACTIVITY_WINDOW_MS ? pollFastMs : pollSlowMs;
+    if ((now - lastPollMs) < interval) return false;
+    lastPollMs = now;
+
+    // Carte déjà lue : vérifier qu'elle est toujours là, sans la relire
+    if (cardPresent) {
+        if (stillPresent()) {
+            lastSeenMs = now;
+            stats.suppressed++;
+        } else if ((now - lastSeenMs) >= RFID_REMOVAL_DEBOUNCE_MS) {
+            cardPresent = false;
+            DEBUG_PRINTLN(F("[RFID] Carte retirée"));
+        }
+        return false;
+    }
+
+    unsigned long t0 = micros();
+
     // Vérifie s'il y a une carte présente
-    bool newCardPresent = mfrc522.PICC_IsNewCardPresent();
+    stats.exchanges++;
+    if (!mfrc522.PICC_IsNewCardPresent()) {
+        return false;
+    }
+
+    // Horodatage détection (traçage latence badge -> relais)
+    detectUs = t0;
 
-    // Si aucune carte, réinitialiser le flag précédent
-    if (!newCardPresent) {
-        cardPreviouslyPresent = false;
-        cardAvailable = false;
+    if (!readUid()) {
+        stats.readErrors++;
         return false;
     }
 
-    // Si la carte est encore présente mais qu'on n'a pas attendu le retrait, ne pas relire
-    if (cardPreviouslyPresent) {
-        cardAvailable = false;
+    // HALT : la carte ne répondra plus au REQA, seulement au WUPA de suivi
+    mfrc522.PICC_HaltA();
+
+    cardAvailable = true;
+    cardPresent = true;
+    lastSeenMs = now;
+    lastActivityMs = now;
+
+    return true;
+}
+
+bool RFIDModule::stillPresent() {
+    byte atqa[2];
+    byte atqaSize = sizeof(atqa);
+
+    stats.exchanges++;
+    MFRC522::StatusCode st = mfrc522.PICC_WakeupA(atqa, &atqaSize);
+    // collision = au moins une carte a répondu
+    if (st != MFRC522::STATUS_OK && st != MFRC522::STATUS_COLLISION) return false;
+
+    mfrc522.PICC_HaltA();
+    return true;
+}
+
+bool RFIDModule::pollIrq() {
+    cardAvailable = false;
+
+    if (!irqFired) {
+        // Ré-armer périodiquement : un REQA sans réponse ne lève pas d'IRQ
+        if ((millis() - lastArmMs) >= RFID_IRQ_REARM_MS) {
+            armReception();
+        }
         return false;
     }
 
-    // Lire la carte
-    if (!mfrc522.PICC_ReadCardSerial()) {
+    noInterrupts();
+    irqFired = false;
+    detectUs = irqAtUs;
+    interrupts();
+
+    mfrc522.PCD_WriteRegister(MFRC522::ComIrqReg, 0x7F);
+
+    bool ok = readUid();
+    if (ok) {
+        // HALT : pas de nouvelle IRQ pour cette carte tant qu'elle reste posée
+        mfrc522.PICC_HaltA();
+        cardAvailable = true;
+    }
+
+    armReception();
+    return ok;
+}
+
+bool RFIDModule::readUid() {
+    // Lire la carte (anticollision + select), avec nouvelles tentatives selon le profil
+    bool ok = mfrc522.PICC_ReadCardSerial();
+    for (uint8_t r = 0; !ok && r < profile.retries; r++) {
+        byte atqa[2];
+        byte atqaSize = sizeof(atqa);
+        stats.exchanges++;
+        if (mfrc522.PICC_WakeupA(atqa, &atqaSize) != MFRC522::STATUS_OK) break;
+        ok = mfrc522.PICC_ReadCardSerial();
+    }
+    if (!ok) {
         DEBUG_PRINTLN(F("[RFID] Erreur lecture UID"));
         return false;
     }
@@ -48,14 +196,29 @@ bool RFIDModule::poll() {
         }
     }
 
+    stats.detections++;
+    stats.detectLatencyUs = micros() - detectUs;
+
     DEBUG_PRINT(F("[RFID] Carte détectée UID: "));
     printUID(uid);
+    return true;
+}
 
-    // Marquer carte disponible et mémoire de présence
-    cardAvailable = true;
-    cardPreviouslyPresent = true;
+// IRqInv (bit 7) : IRQ active à l'état bas ; RxIEn (bit 5) : réception
+void RFIDModule::enableIrqOutput() {
+    mfrc522.PCD_WriteRegister(MFRC522::ComIEnReg, 0xA0);
+    mfrc522.PCD_WriteRegister(MFRC522::ComIrqReg, 0x7F);
+}
 
-    return true;
+void RFIDModule::armReception() {
+    // REQA dans la FIFO puis Transceive : retour immédiat, la réponse
+    // éventuelle (ATQA) lèvera RxIRq sur la broche IRQ.
+    mfrc522.PCD_WriteRegister(MFRC522::ComIrqReg, 0x7F);
+    mfrc522.PCD_WriteRegister(MFRC522::FIFODataReg, MFRC522::PICC_CMD_REQA);
+    mfrc522.PCD_WriteRegister(MFRC522::CommandReg, MFRC522::PCD_Transceive);
+    mfrc522.PCD_WriteRegister(MFRC522::BitFramingReg, 0x87); // StartSend, 7 bits
+    lastArmMs = millis();
+    stats.exchanges++;
 }
 
 bool RFIDModule::hasNewCard() const {
@@ -70,12 +233,153 @@ void RFIDModule::getUID(uint8_t *buffer) {
     printUID(uid);
 }
 
+unsigned long RFIDModule::getDetectMicros() const {
+    return detectUs;
+}
+
+const ReaderProfile &RFIDModule::builtinProfile(uint8_t i) {
+    return PROFILES[i < PROFILE_COUNT ? i : RFID_PROFILE_DEFAULT];
+}
+
+void RFIDModule::applyProfile(const ReaderProfile &p) {
+    profile = p;
+    if (profile.timeoutMs == 0) profile.timeoutMs = 1;
+    if (profile.timeoutMs > 25) profile.timeoutMs = 25;
+
+    mfrc522.PCD_SetAntennaGain(profile.gain);
+
+    // TPrescaler de PCD_Init : 40 kHz -> 40 ticks par ms
+    uint16_t reload = (uint16_t)profile.timeoutMs * 40;
+    mfrc522.PCD_WriteRegister(MFRC522::TReloadRegH, reload >> 8);
+    mfrc522.PCD_WriteRegister(MFRC522::TReloadRegL, reload & 0xFF);
+}
+
+const ReaderProfile &RFIDModule::getProfile() const {
+    return profile;
+}
+
+void RFIDModule::selfTest(const ReaderProfile &p, unsigned long durationMs, RFIDSelfTest &out) {
+    ReaderProfile saved = profile;
+    memset(&out, 0, sizeof(out));
+    applyProfile(p);
+
+    unsigned long busy = 0;
+    unsigned long start = millis();
+    while ((millis() - start) < durationMs && out.attempts < 0xFFFF) {
+        unsigned long t0 = micros();
+        byte atqa[2];
+        byte atqaSize = sizeof(atqa);
+
+        // WUPA : la carte de test répond même si elle est en HALT
+        if (mfrc522.PICC_WakeupA(atqa, &atqaSize) == MFRC522::STATUS_OK &&
+            mfrc522.PICC_ReadCardSerial()) {
+            out.successes++;
+            mfrc522.PICC_HaltA();
+        }
+        busy += micros() - t0;
+        out.attempts++;
+    }
+    out.usPerAttempt = out.attempts ? busy / out.attempts : 0;
+
+    applyProfile(saved);
+    if (mode == RFIDMode::IRQ) armReception();
+}
+
+bool RFIDModule::setMode(RFIDMode m) {
+    if (m == RFIDMode::IRQ && !hasIrq()) return false;
+    mode = m;
+    irqFired = false;
+    if (mode == RFIDMode::IRQ) armReception();
+    return true;
+}
+
+RFIDMode RFIDModule::getMode() const {
+    return mode;
+}
+
+bool RFIDModule::hasIrq() const {
+    return irqPin != 255 && digitalPinToInterrupt(irqPin) != NOT_AN_INTERRUPT;
+}
+
+volatile bool *RFIDModule::irqFlag() {
+    return &irqFired;
+}
+
+const RFIDStats &RFIDModule::getStats() const {
+    return stats;
+}
+
+void RFIDModule::benchmark(RFIDMode m, unsigned long durationMs, RFIDStats &out) {
+    RFIDMode saved = mode;
+    RFIDStats before = stats;
+
+    memset(&out, 0, sizeof(out));
+    if (!setMode(m)) return;
+
+    unsigned long start = millis();
+    while ((millis() - start) < durationMs) {
+        poll();
+    }
+
+    out.polls = stats.polls - before.polls;
+    out.exchanges = stats.exchanges - before.exchanges;
+    out.busyUs = stats.busyUs - before.busyUs;
+    out.detections = stats.detections - before.detections;
+    out.suppressed = stats.suppressed - before.suppressed;
+    out.readErrors = stats.readErrors - before.readErrors;
+    out.detectLatencyUs = out.detections ? stats.detectLatencyUs : 0;
+
+    setMode(saved);
+}
+
 void RFIDModule::halt() {
     DEBUG_PRINTLN(F("[RFID] Halt carte"));
     mfrc522.PICC_HaltA();
     mfrc522.PCD_StopCrypto1();
 }
 
+void RFIDModule::releaseBus() {
+    pinMode(ssPin, OUTPUT);
+    digitalWrite(ssPin, HIGH);
+}
+
+bool RFIDModule::probe() {
+    // Bus SPI flottant / lecteur absent : 0x00 ou 0xFF
+    byte v = mfrc522.PCD_ReadRegister(MFRC522::VersionReg);
+    return v != 0x00 && v != 0xFF;
+}
+
+void RFIDModule::reinit() {
+    // Rebranché / ré-alimenté : le MFRC522 est revenu à ses valeurs de reset
+    // (gain, timer, IRQ désactivée), rien de begin() n'a survécu
+    mfrc522.PCD_Init();
+    applyProfile(profile);
+    cardAvailable = false;
+    cardPresent = false;
+
+    if (mode == RFIDMode::IRQ) {
+        enableIrqOutput();
+        irqFired = false;
+        armReception();
+    }
+    DEBUG_PRINTLN(F("[RFID] Lecteur ré-initialisé"));
+}
+
+/* ===== IRQ ===== */
+
+void RFIDModule::onIrq() {
+    irqAtUs = micros();
+    irqFired = true;
+}
+
+void RFIDModule::irqTrampoline0() {
+    if (irqOwners[0]) irqOwners[0]->onIrq();
+}
+
+void RFIDModule::irqTrampoline1() {
+    if (irqOwners[1]) irqOwners[1]->onIrq();
+}
+
 void RFIDModule::printUID(const uint8_t *uid) {
     // Print each byte as two hex digits separated by space
     for (uint8_t i = 0; i < UID_SIZE; i++) {
@@ -88,4 +392,4 @@ void RFIDModule::printUID(const uint8_t *uid) {
         DEBUG_PRINT(' ');
     }
     DEBUG_PRINTLN();
-}
\ No newline at end of file
+}
@@ -4,26 +4,129 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <MFRC522.h>
+#include "../config.h"
+
+/*
+  RFIDModule
+  - POLLING : PICC_IsNewCardPresent() à chaque poll (REQA + attente du timeout
+              du lecteur, ~25 ms sans carte).
+  - IRQ     : la broche IRQ du MFRC522 est reliée à une interruption externe.
+              poll() arme la réception (REQA envoyé, retour immédiat) au plus
+              toutes les RFID_IRQ_REARM_MS et ne lance anticollision/select
+              que lorsque l'IRQ RxIRq tombe. La carte lue est mise en HALT :
+              elle ne répond plus au REQA tant qu'elle n'a pas quitté le champ.
+  - Sans broche IRQ câblée (255), le mode POLLING reste utilisé.
+  - En POLLING, cadence adaptative : RFID_POLL_FAST_MS pendant
+    RFID_ACTIVITY_WINDOW_MS après une lecture, RFID_POLL_SLOW_MS sinon.
+  - Suivi de présence : une carte lue est mise en HALT puis sondée par WUPA
+    (qui réveille aussi les cartes HALT). Elle n'est considérée retirée qu'après
+    RFID_REMOVAL_DEBOUNCE_MS sans réponse : pas de relecture tant qu'elle reste posée.
+*/
+
+// Profil de transaction lecteur : portée vs temps de boucle
+// (l'horloge SPI est fixée à la compilation : -DMFRC522_SPICLOCK=..., la
+//  bibliothèque MFRC522 construit ses SPISettings à partir de cette macro)
+struct ReaderProfile {
+    uint8_t gain;        // RFCfgReg RxGain (MFRC522::RxGain_*)
+    uint8_t timeoutMs;   // timer de réception du lecteur (TReload), 1..25 ms
+    uint8_t retries;     // nouvelles tentatives anticollision/select après échec
+};
+
+// Résultat d'un auto-test de profil (carte posée sur le lecteur)
+struct RFIDSelfTest {
+    uint16_t attempts;
+    uint16_t successes;
+    uint32_t usPerAttempt;
+};
+
+enum class RFIDMode : uint8_t {
+    POLLING,
+    IRQ
+};
+
+// Compteurs cumulés depuis le boot (ou résultat d'un benchmark)
+struct RFIDStats {
+    uint32_t polls;              // appels à poll()
+    uint32_t exchanges;          // échanges REQA émis sur le bus SPI
+    uint32_t busyUs;             // temps passé dans poll()
+    uint32_t detections;         // UID lus avec succès
+    uint32_t suppressed;         // carte toujours posée : relecture évitée
+    uint32_t readErrors;         // REQA OK mais anticollision/select en échec
+    uint32_t detectLatencyUs;    // dernière latence détection -> UID prêt
+};
 
 class RFIDModule {
 public:
     static const uint8_t UID_SIZE = 5;
 
-    RFIDModule(uint8_t ssPin, uint8_t rstPin);
+    RFIDModule(uint8_t ssPin, uint8_t rstPin, uint8_t irqPin = 255);
 
     void begin();
     bool poll();                  // vérifie la présence d'une carte (non bloquant)
     bool hasNewCard() const;      // retourne true si une nouvelle carte est détectée
     void getUID(uint8_t *buffer); // copie UID dans buffer
     void halt();                  // met fin à la communication avec la carte
+    bool probe();                 // lecteur présent sur le bus (VersionReg valide)
+    void reinit();                // registres reprogrammés (lecteur revenu en ligne)
+    void releaseBus();            // SS à l'état haut (bus partagé, avant tout begin())
+
+    unsigned long getDetectMicros() const; // horodatage (micros) de la dernière détection
+
+    bool setMode(RFIDMode m);     // false si IRQ demandé sans broche câblée
+    RFIDMode getMode() const;
+    bool hasIrq() const;
+    volatile bool *irqFlag();     // pour PowerManager::watchFlag()
+
+    const RFIDStats &getStats() const;
+
+    static const uint8_t PROFILE_COUNT = 3;           // 0 = rapide, 1 = équilibré, 2 = portée
+    static const ReaderProfile &builtinProfile(uint8_t i);
+    void applyProfile(const ReaderProfile &p);
+    const ReaderProfile &getProfile() const;
+
+    // WUPA + select + HALT en boucle pendant durationMs avec le profil p (bloquant)
+    void selfTest(const ReaderProfile &p, unsigned long durationMs, RFIDSelfTest &out);
+
+    // Mesure poll() en boucle dans le mode donné pendant durationMs (bloquant)
+    void benchmark(RFIDMode m, unsigned long durationMs, RFIDStats &out);
 
 private:
     MFRC522 mfrc522;
+    uint8_t ssPin;
+    uint8_t irqPin;
+    RFIDMode mode;
+
     bool cardAvailable;           // flag pour indiquer qu'une carte est prête
-    bool cardPreviouslyPresent;   // flag pour empêcher lecture répétée si carte non retirée
+    bool cardPresent;             // carte lue et toujours dans le champ (HALT)
+    unsigned long lastSeenMs;     // dernière réponse WUPA de la carte présente
+    unsigned long lastActivityMs; // dernière lecture (cadence rapide)
+    unsigned long lastPollMs;
+    uint16_t pollFastMs;
+    uint16_t pollSlowMs;
     uint8_t uid[UID_SIZE];
+    unsigned long detectUs;       // micros() au moment où la carte a été vue dans le champ
+
+    volatile bool irqFired;
+    volatile unsigned long irqAtUs;
+    unsigned long lastArmMs;
+
+    RFIDStats stats;
+    ReaderProfile profile;
+
+    bool pollClassic();
+    bool stillPresent();
+    bool pollIrq();
+    bool readUid();
+    void armReception();
+    void enableIrqOutput();
+    void onIrq();
+
+    static RFIDModule *irqOwners[RFID_MAX_IRQ_READERS];
+    static void irqTrampoline0();
+    static void irqTrampoline1();
+    static void (*const irqTrampolines[])();
 
     void printUID(const uint8_t *uid); // debug: affiche UID sur Serial
 };
 
-#endif
\ No newline at end of file
+#endif
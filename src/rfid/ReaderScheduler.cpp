@@ -0,0 +1,117 @@
+#include "ReaderScheduler.h"
+
+ReaderScheduler::ReaderScheduler(RFIDModule **readersIn, uint8_t countIn)
+    : readers(readersIn),
+      n(countIn > RFID_MAX_READERS ? RFID_MAX_READERS : countIn),
+      next(0),
+      currentIdx(0),
+      newCard(false)
+{
+    memset(online, 0, sizeof(online));
+    memset(strikes, 0, sizeof(strikes));
+    memset(lastProbeMs, 0, sizeof(lastProbeMs));
+}
+
+void ReaderScheduler::begin() {
+    // Tous les SS à l'état haut avant d'initialiser le premier lecteur
+    for (uint8_t i = 0; i < n; i++) {
+        readers[i]->releaseBus();
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        readers[i]->begin();
+        online[i] = readers[i]->probe();
+        lastProbeMs[i] = millis();
+        DEBUG_PRINT(F("[RFID] Lecteur "));
+        DEBUG_PRINT(i);
+        DEBUG_PRINTLN(online[i] ? F(" en ligne") : F(" absent"));
+    }
+}
+
+int8_t ReaderScheduler::poll() {
+    newCard = false;
+    unsigned long now = millis();
+
+    for (uint8_t k = 0; k < n; k++) {
+        uint8_t i = next;
+        next = (next + 1) % n;
+
+        // Re-sonde périodique : lecteurs hors ligne ET en ligne (débranchement)
+        if ((now - lastProbeMs[i]) >= RFID_REPROBE_MS) {
+            probe(i);
+        }
+        if (!online[i]) continue;
+
+        RFIDModule *r = readers[i];
+        uint32_t exchangesBefore = r->getStats().exchanges;
+        unsigned long t0 = micros();
+
+        bool got = r->poll() && r->hasNewCard();
+
+        unsigned long dt = micros() - t0;
+        if (dt > RFID_SLICE_BUDGET_US) {
+            if (++strikes[i] >= RFID_SLOW_STRIKES) {
+                online[i] = false;
+                lastProbeMs[i] = now;
+                DEBUG_PRINT(F("[RFID] Lecteur trop lent, hors ligne: "));
+                DEBUG_PRINTLN(i);
+            }
+        } else {
+            strikes[i] = 0;
+        }
+
+        if (got) {
+            currentIdx = i;
+            newCard = true;
+            return i;
+        }
+
+        // Un seul échange bus par passage : laisser la main au reste de loop()
+        if (r->getStats().exchanges != exchangesBefore) break;
+    }
+    return -1;
+}
+
+bool ReaderScheduler::hasNewCard() const {
+    return newCard;
+}
+
+void ReaderScheduler::getUID(uint8_t *buffer) {
+    readers[currentIdx]->getUID(buffer);
+}
+
+void ReaderScheduler::halt() {
+    readers[currentIdx]->halt();
+}
+
+uint8_t ReaderScheduler::currentIndex() const {
+    return currentIdx;
+}
+
+RFIDModule &ReaderScheduler::current() {
+    return *readers[currentIdx];
+}
+
+RFIDModule &ReaderScheduler::get(uint8_t i) {
+    return *readers[i < n ? i : 0];
+}
+
+uint8_t ReaderScheduler::count() const {
+    return n;
+}
+
+bool ReaderScheduler::isOnline(uint8_t i) const {
+    return i < n && online[i];
+}
+
+/* ===== PRIVATE ===== */
+
+void ReaderScheduler::probe(uint8_t i) {
+    bool wasOnline = online[i];
+    online[i] = readers[i]->probe();
+    lastProbeMs[i] = millis();
+    if (online[i] && !wasOnline) {
+        strikes[i] = 0;
+        readers[i]->reinit();
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef READER_SCHEDULER_H
+#define READER_SCHEDULER_H
+
+#include <Arduino.h>
+#include "RFIDModule.h"
+
+/*
+  ReaderScheduler
+  - Plusieurs RFIDModule sur le même bus SPI (un SS par lecteur)
+  - poll() : round-robin, au plus UN échange SPI lecteur par passage de loop()
+    (les lecteurs dont la cadence n'est pas échue sont sautés sans coût)
+    -> coût total linéaire en nombre de lecteurs, équitable entre eux.
+  - Lecteur absent (VersionReg 0x00/0xFF) ou trop lent (RFID_SLICE_BUDGET_US
+    dépassé RFID_SLOW_STRIKES fois de suite) : mis hors ligne, re-sondé
+    toutes les RFID_REPROBE_MS sans bloquer les autres. De retour en ligne,
+    il est ré-initialisé (PCD_Init, profil, IRQ) avant d'être interrogé.
+  - Le dernier lecteur ayant produit une carte est le lecteur "courant"
+    (getUID / halt / hasNewCard s'y appliquent).
+*/
+
+class ReaderScheduler {
+public:
+    ReaderScheduler(RFIDModule **readers, uint8_t count);
+
+    void begin();
+
+    int8_t poll();                 // index du lecteur avec nouvelle carte, -1 sinon
+    bool hasNewCard() const;       // carte produite au dernier poll()
+    void getUID(uint8_t *buffer);
+    void halt();
+
+    uint8_t currentIndex() const;
+    RFIDModule &current();
+    RFIDModule &get(uint8_t i);
+    uint8_t count() const;
+    bool isOnline(uint8_t i) const;
+
+private:
+    RFIDModule **readers;
+    uint8_t n;
+    uint8_t next;
+    uint8_t currentIdx;
+    bool newCard;
+
+    bool online[RFID_MAX_READERS];
+    uint8_t strikes[RFID_MAX_READERS];
+    unsigned long lastProbeMs[RFID_MAX_READERS];
+
+    void probe(uint8_t i);
+};
+
+#endif // READER_SCHEDULER_H
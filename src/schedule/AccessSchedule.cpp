@@ -0,0 +1,65 @@
+#include "AccessSchedule.h"
+
+static const uint8_t SLOTS_PER_DAY = 48;   // créneaux de 30 min
+
+AccessSchedule::AccessSchedule(EEPROMStore &storeRef, const SoftClock &clockRef)
+    : store(storeRef),
+      clock(clockRef)
+{
+    memset(bitmaps, 0, sizeof(bitmaps));
+}
+
+void AccessSchedule::begin() {
+    for (uint8_t t = 0; t < SCHEDULE_TEMPLATES; t++) {
+        store.readScheduleTemplate(t + 1, bitmaps[t]);
+    }
+    DEBUG_PRINTLN(F("[SCHEDULE] Modèles chargés"));
+}
+
+ScheduleVerdict AccessSchedule::check(uint8_t templateIndex) const {
+    if (templateIndex == 0 || templateIndex > SCHEDULE_TEMPLATES) {
+        return ScheduleVerdict::ALLOWED; // 24/7
+    }
+
+    if (!clock.isSynced()) {
+#if SCHEDULE_UNSYNCED_ALLOW
+        return ScheduleVerdict::ALLOWED;
+#else
+        return ScheduleVerdict::CLOCK_UNSYNCED;
+#endif
+    }
+
+    uint16_t slot = (uint16_t)clock.weekday() * SLOTS_PER_DAY + clock.minuteOfDay() / 30;
+    const uint8_t *bm = bitmaps[templateIndex - 1];
+    bool allowed = bm[slot >> 3] & (1 << (slot & 7));
+    return allowed ? ScheduleVerdict::ALLOWED : ScheduleVerdict::OUTSIDE_WINDOW;
+}
+
+bool AccessSchedule::addWindow(uint8_t templateIndex, uint8_t daysMask, uint16_t startMin, uint16_t endMin) {
+    if (templateIndex == 0 || templateIndex > SCHEDULE_TEMPLATES) return false;
+    if (daysMask == 0 || daysMask > 0x7F) return false;
+    if (endMin > 1440 || startMin >= endMin) return false;
+
+    uint8_t *bm = bitmaps[templateIndex - 1];
+    uint8_t first = startMin / 30;
+    uint8_t last = (endMin + 29) / 30;  // créneau de fin exclu, arrondi au-dessus
+
+    for (uint8_t d = 0; d < 7; d++) {
+        if (!(daysMask & (1 << d))) continue;
+        for (uint8_t s = first; s < last; s++) {
+            uint16_t slot = (uint16_t)d * SLOTS_PER_DAY + s;
+            bm[slot >> 3] |= (1 << (slot & 7));
+        }
+    }
+
+    store.writeScheduleTemplate(templateIndex, bm);
+    return true;
+}
+
+bool AccessSchedule::clear(uint8_t templateIndex) {
+    if (templateIndex == 0 || templateIndex > SCHEDULE_TEMPLATES) return false;
+
+    memset(bitmaps[templateIndex - 1], 0, EEPROMStore::SCHEDULE_BITMAP_SIZE);
+    store.writeScheduleTemplate(templateIndex, bitmaps[templateIndex - 1]);
+    return true;
+}
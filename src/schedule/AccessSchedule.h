@@ -0,0 +1,44 @@
+#ifndef ACCESS_SCHEDULE_H
+#define ACCESS_SCHEDULE_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "../eeprom/EEPROMStore.h"
+#include "SoftClock.h"
+
+/*
+  AccessSchedule
+  - Modèles horaires hebdomadaires partagés entre badges : bitmap de
+    7 x 48 créneaux de 30 min (42 octets) par modèle
+  - Modèle 0 (ou 0xFF, EEPROM vierge) = accès 24/7, non stocké
+  - Les bitmaps sont chargés une fois en RAM au boot : allows() est une
+    lecture de bit, aucun accès EEPROM sur le chemin du badge
+  - Modification : addWindow() / clear() écrivent aussi en EEPROM
+*/
+
+enum class ScheduleVerdict : uint8_t {
+    ALLOWED,
+    OUTSIDE_WINDOW,
+    CLOCK_UNSYNCED
+};
+
+class AccessSchedule {
+public:
+    AccessSchedule(EEPROMStore &store, const SoftClock &clock);
+
+    void begin();
+
+    ScheduleVerdict check(uint8_t templateIndex) const;
+
+    // jours : bit 0 = lundi ... bit 6 = dimanche ; minutes [start, end) dans la journée
+    bool addWindow(uint8_t templateIndex, uint8_t daysMask, uint16_t startMin, uint16_t endMin);
+    bool clear(uint8_t templateIndex);
+
+private:
+    EEPROMStore &store;
+    const SoftClock &clock;
+
+    uint8_t bitmaps[SCHEDULE_TEMPLATES][EEPROMStore::SCHEDULE_BITMAP_SIZE];
+};
+
+#endif // ACCESS_SCHEDULE_H
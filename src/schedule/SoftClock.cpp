@@ -0,0 +1,43 @@
+#include "SoftClock.h"
+
+SoftClock::SoftClock()
+    : epoch(0),
+      syncMs(0),
+      synced(false)
+{
+}
+
+void SoftClock::update() {
+    if (!synced) return;
+
+    // Replier toutes les heures : millis() - syncMs reste loin du rebouclage
+    unsigned long elapsed = millis() - syncMs;
+    if (elapsed >= 3600000UL) {
+        uint32_t secs = elapsed / 1000UL;
+        epoch += secs;
+        syncMs += secs * 1000UL;
+    }
+}
+
+void SoftClock::setEpoch(uint32_t epochSeconds) {
+    epoch = epochSeconds;
+    syncMs = millis();
+    synced = true;
+}
+
+bool SoftClock::isSynced() const {
+    return synced;
+}
+
+uint32_t SoftClock::now() const {
+    return epoch + (millis() - syncMs) / 1000UL;
+}
+
+uint8_t SoftClock::weekday() const {
+    // 1970-01-01 était un jeudi (index 3 avec lundi = 0)
+    return (uint8_t)(((now() / 86400UL) + 3UL) % 7UL);
+}
+
+uint16_t SoftClock::minuteOfDay() const {
+    return (uint16_t)((now() % 86400UL) / 60UL);
+}
@@ -0,0 +1,34 @@
+#ifndef SOFT_CLOCK_H
+#define SOFT_CLOCK_H
+
+#include <Arduino.h>
+
+/*
+  SoftClock
+  - Horloge logicielle (pas de RTC matériel) synchronisée par l'hôte
+  - L'hôte envoie l'heure LOCALE en secondes depuis 1970 (pas de fuseau géré ici)
+  - update() replie le temps écoulé régulièrement : pas de dérive au
+    rebouclage de millis() (49,7 jours)
+  - Non synchronisée après un reset : isSynced() == false
+*/
+
+class SoftClock {
+public:
+    SoftClock();
+
+    void update();
+
+    void setEpoch(uint32_t epochSeconds);
+    bool isSynced() const;
+    uint32_t now() const;              // secondes (heure locale) depuis 1970
+
+    uint8_t weekday() const;           // 0 = lundi ... 6 = dimanche
+    uint16_t minuteOfDay() const;      // 0..1439
+
+private:
+    uint32_t epoch;                    // valeur à syncMs
+    unsigned long syncMs;
+    bool synced;
+};
+
+#endif // SOFT_CLOCK_H
@@ -0,0 +1,35 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <Arduino.h>
+
+/*
+  InputTrace
+  - Hooks on every input the firmware consumes, for deterministic replay
+    (Linux simulator --record / --replay):
+      RX    : byte read by JsonComm::receiveCommand()
+      UID   : badge returned by RFIDModule::poll()
+      KEY   : key delivered by KeypadModule::update()
+      STAGE : LatencyTrace stage (host CPU time per stage on replay)
+  - The backend timestamps each entry with millis()
+  - Without INPUT_TRACE (board builds) the macros expand to nothing
+*/
+
+#if defined(INPUT_TRACE)
+void inputTraceRx(uint8_t b);
+void inputTraceUid(uint8_t ssPin, const uint8_t *uid, uint8_t len);
+void inputTraceKey(char key);
+void inputTraceStage(const char *stage, bool first);
+
+#define INPUT_TRACE_RX(b) inputTraceRx(b)
+#define INPUT_TRACE_UID(ss, uid, len) inputTraceUid(ss, uid, len)
+#define INPUT_TRACE_KEY(k) inputTraceKey(k)
+#define INPUT_TRACE_STAGE(name, first) inputTraceStage(name, first)
+#else
+#define INPUT_TRACE_RX(b) do {} while (0)
+#define INPUT_TRACE_UID(ss, uid, len) do {} while (0)
+#define INPUT_TRACE_KEY(k) do {} while (0)
+#define INPUT_TRACE_STAGE(name, first) do {} while (0)
+#endif
+
+#endif // INPUT_TRACE_H
@@ -0,0 +1,93 @@
+#include "LatencyTrace.h"
+#include "InputTrace.h"
+
+LatencyTrace::LatencyTrace()
+    : marked(0),
+      active(false),
+      head(0),
+      count(0)
+{
+    memset(stamps, 0, sizeof(stamps));
+    memset(samples, 0, sizeof(samples));
+}
+
+void LatencyTrace::start(unsigned long detectUs) {
+    marked = 0;
+    active = true;
+    stamps[(uint8_t)TraceStage::DETECT] = detectUs;
+    marked |= (1 << (uint8_t)TraceStage::DETECT);
+    INPUT_TRACE_STAGE(stageName((uint8_t)TraceStage::DETECT), true);
+}
+
+void LatencyTrace::mark(TraceStage s) {
+    if (!active) return;
+    stamps[(uint8_t)s] = micros();
+    marked |= (1 << (uint8_t)s);
+    INPUT_TRACE_STAGE(stageName((uint8_t)s), false);
+}
+
+void LatencyTrace::finish() {
+    if (!active) return;
+    const uint8_t relayBit = 1 << (uint8_t)TraceStage::RELAY;
+    if (marked & relayBit) {
+        // unsigned arithmetic handles micros() wrap-around
+        samples[head] = stamps[(uint8_t)TraceStage::RELAY] - stamps[(uint8_t)TraceStage::DETECT];
+        head = (head + 1) % WINDOW;
+        if (count < WINDOW) count++;
+    }
+    active = false;
+}
+
+void LatencyTrace::abort() {
+    active = false;
+}
+
+bool LatencyTrace::isActive() const {
+    return active;
+}
+
+void LatencyTrace::attach(JsonObject dst) const {
+    unsigned long t0 = stamps[(uint8_t)TraceStage::DETECT];
+    for (uint8_t s = 0; s < (uint8_t)TraceStage::COUNT; s++) {
+        if (marked & (1 << s)) {
+            dst[stageName(s)] = (uint32_t)(stamps[s] - t0);
+        }
+    }
+}
+
+uint32_t LatencyTrace::percentile(uint8_t pct) const {
+    if (count == 0) return 0;
+    if (pct > 100) pct = 100;
+
+    // small window: copy + insertion sort on the stack (WINDOW * 4 bytes)
+    uint32_t sorted[WINDOW];
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t v = samples[i];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    // nearest-rank
+    uint16_t rank = ((uint16_t)pct * count + 99) / 100;
+    if (rank == 0) rank = 1;
+    return sorted[rank - 1];
+}
+
+uint8_t LatencyTrace::sampleCount() const {
+    return count;
+}
+
+const char* LatencyTrace::stageName(uint8_t s) {
+    switch ((TraceStage)s) {
+        case TraceStage::DETECT: return "detect";
+        case TraceStage::UID: return "uid";
+        case TraceStage::LOOKUP: return "lookup";
+        case TraceStage::OPEN_DOOR: return "open_door";
+        case TraceStage::RELAY: return "relay";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/*
+  LatencyTrace
+  - Timestamps (micros) each stage of the badge -> relay path:
+      DETECT    : RFIDModule::poll() sees a card in the field
+      UID       : getUID() done
+      LOOKUP    : EEPROMStore::badgeExists() done
+      OPEN_DOOR : FSMAction::OPEN_DOOR handled
+      RELAY     : RelayBank::open() returned
+  - attach() writes the stage offsets (us, relative to DETECT) into an event
+  - finish() pushes the end-to-end latency into a rolling window (p50/p99)
+*/
+
+enum class TraceStage : uint8_t {
+    DETECT,
+    UID,
+    LOOKUP,
+    OPEN_DOOR,
+    RELAY,
+    COUNT
+};
+
+class LatencyTrace {
+public:
+    static const uint8_t WINDOW = 32; // rolling window of end-to-end samples
+
+    LatencyTrace();
+
+    void start(unsigned long detectUs); // new trace, DETECT stamp given by RFIDModule
+    void mark(TraceStage s);            // stamp a stage with micros()
+    void finish();                      // record DETECT -> RELAY in the window
+    void abort();                       // drop current trace (access denied, ...)
+    bool isActive() const;
+
+    // Write {"detect":0,"uid":..,"lookup":..,...} (only marked stages)
+    void attach(JsonObject dst) const;
+
+    // Percentile (0..100) over the rolling window, 0 if empty
+    uint32_t percentile(uint8_t pct) const;
+    uint8_t sampleCount() const;
+
+private:
+    unsigned long stamps[(uint8_t)TraceStage::COUNT];
+    uint8_t marked;    // bitmask of stamped stages
+    bool active;
+
+    uint32_t samples[WINDOW];
+    uint8_t head;
+    uint8_t count;
+
+    static const char* stageName(uint8_t s);
+};
+
+#endif // LATENCY_TRACE_H
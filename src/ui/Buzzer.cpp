@@ -0,0 +1,45 @@
+#include "Buzzer.h"
+
+Buzzer::Buzzer(uint8_t pinIn)
+    : pin(pinIn),
+      startMs(0),
+      durationMs(0),
+      current(BuzzPriority::KEY_CLICK),
+      dropped(0)
+{
+}
+
+void Buzzer::begin() {
+    if (pin == 255) return;
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);
+}
+
+bool Buzzer::play(uint16_t freq, uint16_t duration, BuzzPriority priority) {
+    if (pin == 255 || duration == 0) return false;
+
+    if (isBusy() && priority < current) {
+        dropped++;
+        return false;
+    }
+
+    tone(pin, freq, duration);   // remplace le son en cours s'il y en a un
+    startMs = millis();
+    durationMs = duration;
+    current = priority;
+    return true;
+}
+
+void Buzzer::stop() {
+    if (pin == 255) return;
+    noTone(pin);
+    durationMs = 0;
+}
+
+bool Buzzer::isBusy() const {
+    return durationMs != 0 && (millis() - startMs) < durationMs;
+}
+
+uint16_t Buzzer::getDropped() const {
+    return dropped;
+}
@@ -0,0 +1,44 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include <Arduino.h>
+
+/*
+  Buzzer
+  - Seul propriétaire de la broche buzzer : clavier et UIFeedback passent par ici
+    au lieu d'appeler tone() chacun de leur côté.
+  - Non bloquant : tone(pin, freq, durée), la fin du son est gérée par le timer de tone().
+  - Arbitrage par priorité : un son de priorité >= à celui en cours le remplace,
+    un son de priorité inférieure est ignoré tant que le buzzer est occupé
+    (un bip de touche ne coupe pas un refus d'accès).
+  - A appeler depuis loop() uniquement (tone() n'est pas sûr en ISR).
+*/
+
+enum class BuzzPriority : uint8_t {
+    KEY_CLICK,    // retour de frappe clavier
+    PIN_RESULT,   // PIN accepté / refusé
+    FEEDBACK      // motifs UIFeedback (accès, erreurs, confirmations)
+};
+
+class Buzzer {
+public:
+    explicit Buzzer(uint8_t pin = 255);
+
+    void begin();
+
+    // false si ignoré (buzzer occupé par un son plus prioritaire, ou non câblé)
+    bool play(uint16_t freq, uint16_t durationMs, BuzzPriority priority);
+    void stop();
+    bool isBusy() const;
+
+    uint16_t getDropped() const;   // sons ignorés par l'arbitrage
+
+private:
+    uint8_t pin;
+    unsigned long startMs;
+    uint16_t durationMs;
+    BuzzPriority current;
+    uint16_t dropped;
+};
+
+#endif // BUZZER_H
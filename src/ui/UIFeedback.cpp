@@ -5,8 +5,8 @@
 #define DEBUG_PRINT(x) Serial.print(x)
 #endif
 
-UIFeedback::UIFeedback(uint8_t ledGreenPin, uint8_t ledRedPin, uint8_t buzzerPin)
-    : ledGreen(ledGreenPin), ledRed(ledRedPin), buzzer(buzzerPin)
+UIFeedback::UIFeedback(uint8_t ledGreenPin, uint8_t ledRedPin, Buzzer *buzzerIn)
+    : ledGreen(ledGreenPin), ledRed(ledRedPin), buzzer(buzzerIn)
 {
 }
 
@@ -15,7 +15,6 @@ void UIFeedback::begin() {
     pinMode(ledRed, OUTPUT);
     digitalWrite(ledGreen, LOW);
     digitalWrite(ledRed, LOW);
-    if (buzzer != 255) pinMode(buzzer, OUTPUT);
 }
 
 void UIFeedback::signal(FeedbackType t) {
@@ -85,6 +84,6 @@ void UIFeedback::signal(FeedbackType t) {
 }
 
 void UIFeedback::toneBeep(uint16_t freq, uint16_t duration) {
-    if (buzzer == 255) return;
-    tone(buzzer, freq, duration);
+    if (!buzzer) return;
+    buzzer->play(freq, duration, BuzzPriority::FEEDBACK);
 }
\ No newline at end of file
@@ -2,10 +2,12 @@
 #define UI_FEEDBACK_H
 
 #include <Arduino.h>
+#include "Buzzer.h"
 
 /*
   UIFeedback
   - Helper to control LEDs and buzzer for feedback patterns
+  - Tones go through the shared Buzzer (BuzzPriority::FEEDBACK), never tone() directly
 */
 
 enum class FeedbackType : uint8_t {
@@ -22,7 +24,7 @@ enum class FeedbackType : uint8_t {
 
 class UIFeedback {
 public:
-    UIFeedback(uint8_t ledGreenPin, uint8_t ledRedPin, uint8_t buzzerPin = 255);
+    UIFeedback(uint8_t ledGreenPin, uint8_t ledRedPin, Buzzer *buzzer = nullptr);
 
     void begin();
     void signal(FeedbackType t);
@@ -30,7 +32,7 @@ public:
 private:
     uint8_t ledGreen;
     uint8_t ledRed;
-    uint8_t buzzer;
+    Buzzer *buzzer;
 
     void toneBeep(uint16_t freq, uint16_t duration);
 };
@@ -0,0 +1,296 @@
+/*
+  test_eeprom_migration — migration EEPROM interrompue par une coupure
+  - Image de la version précédente (badges, PIN, compteurs de blocage)
+    fabriquée puis migrée par EEPROMStore::begin() sur l'EEPROM simulée
+    (src/hal/linux).
+  - EEPROM.cutPowerAfter(n) perd toutes les écritures après la n-ième :
+    un begin() coupé puis un begin() complet = redémarrage après coupure.
+  - Aucune coupure pendant la migration, CRC compris, ne doit effacer
+    les badges.
+  - Chaque zone est ajoutée après les précédentes : une image en version N
+    est l'image courante vierge après la zone de la version N. Depuis
+    chaque version, avec ou sans coupure, les données que cette version
+    connaissait (horaires, modèles, rôles, profil lecteur) sont conservées.
+
+  pio test -e native_test -f test_eeprom_migration
+*/
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <unity.h>
+
+#include "eeprom/EEPROMStore.h"
+
+static const uint16_t OFF_VERSION = 2;
+static const uint16_t CORE_END = 14 + EEPROMStore::UID_SIZE * EEPROMStore::MAX_BADGES;
+static const uint16_t OFF_CRC = EEPROMClass::SIZE - 2;
+static const uint16_t OFF_PROFILE = CORE_END + EEPROMStore::HEALTH_SIZE;
+
+// Taille de la zone ajoutée par chaque version (index = version - 1)
+static const uint16_t AREA_SIZE[] = {
+    CORE_END,                                                   // v1 en-tête + badges
+    EEPROMStore::HEALTH_SIZE,                                   // v2 santé
+    2,                                                          // v3 profil lecteur
+    EEPROMStore::MAX_BADGES + SCHEDULE_TEMPLATES * EEPROMStore::SCHEDULE_BITMAP_SIZE, // v4 horaires
+    AUDIT_RECORDS * EEPROMStore::AUDIT_RECORD_SIZE,             // v5 journal
+    EEPROMStore::MAX_BADGES,                                    // v6 rôles
+    EEPROMStore::CONFIG_AREA_SIZE,                              // v7 config
+    EEPROMStore::LOCKOUT_SOURCES * 3,                           // v8 verrouillage
+};
+static_assert(sizeof(AREA_SIZE) / sizeof(AREA_SIZE[0]) == EEPROM_VERSION,
+              "une zone par version : compléter AREA_SIZE");
+
+static const uint8_t BADGES[][EEPROMStore::UID_SIZE] = {
+    { 0x04, 0xA1, 0x22, 0x3B, 0x10 },
+    { 0x04, 0x5C, 0x91, 0x07, 0x2E },
+    { 0x08, 0x11, 0xE3, 0x40, 0x9A },
+};
+static const uint8_t BADGE_COUNT = sizeof(BADGES) / sizeof(BADGES[0]);
+
+static uint8_t prevImage[EEPROMClass::SIZE];
+static uint8_t fullImage[EEPROMClass::SIZE];
+static uint8_t bitmap[EEPROMStore::SCHEDULE_BITMAP_SIZE];
+
+// CRC16-CCITT du cœur (en-tête + badges), comme EEPROMStore::computeCRC16
+static uint16_t coreCrc() {
+    uint16_t crc = 0xFFFF;
+    for (uint16_t a = 0; a < CORE_END; a++) {
+        crc ^= (uint16_t)EEPROM.read(a) << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t storedVersion() {
+    return EEPROM.read(OFF_VERSION) | ((uint16_t)EEPROM.read(OFF_VERSION + 1) << 8);
+}
+
+// Disposition courante remplie puis ramenée à la version précédente (version
+// et CRC), compteurs de blocage non nuls pour que la dernière étape écrive
+static void buildPrevImage() {
+    uint8_t erased[EEPROMClass::SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    EEPROM.load(erased, sizeof(erased));
+
+    EEPROMStore store;
+    store.begin();
+    for (uint8_t i = 0; i < BADGE_COUNT; i++) {
+        TEST_ASSERT_TRUE(store.addBadge(BADGES[i]));
+    }
+    store.writeLockout(0, 3, 2);
+    store.writeLockout(1, 5, 1);
+
+    EEPROM.update(OFF_VERSION, (EEPROM_VERSION - 1) & 0xFF);
+    EEPROM.update(OFF_VERSION + 1, (EEPROM_VERSION - 1) >> 8);
+    uint16_t crc = coreCrc();
+    EEPROM.update(OFF_CRC, crc & 0xFF);
+    EEPROM.update(OFF_CRC + 1, crc >> 8);
+
+    memcpy(prevImage, EEPROM.image(), sizeof(prevImage));
+}
+
+static void setVersion(uint16_t version) {
+    EEPROM.update(OFF_VERSION, version & 0xFF);
+    EEPROM.update(OFF_VERSION + 1, version >> 8);
+    uint16_t crc = coreCrc();
+    EEPROM.update(OFF_CRC, crc & 0xFF);
+    EEPROM.update(OFF_CRC + 1, crc >> 8);
+}
+
+static uint16_t areaEnd(uint16_t version) {
+    uint16_t end = 0;
+    for (uint16_t v = 0; v < version; v++) end += AREA_SIZE[v];
+    return end;
+}
+
+// Disposition courante complète : badge 1 sur le modèle 2, badge 0
+// superviseur, profil lecteur 2 (config et ancienne paire v3)
+static void buildFullImage() {
+    uint8_t erased[EEPROMClass::SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    EEPROM.load(erased, sizeof(erased));
+
+    EEPROMStore store;
+    store.begin();
+    for (uint8_t i = 0; i < BADGE_COUNT; i++) {
+        TEST_ASSERT_TRUE(store.addBadge(BADGES[i]));
+    }
+    TEST_ASSERT_TRUE(store.setBadgeSchedule(1, 2));
+    TEST_ASSERT_TRUE(store.setBadgeRoles(0, EEPROMStore::ROLE_USER | EEPROMStore::ROLE_SUPERVISOR));
+    store.writeScheduleTemplate(2, bitmap);
+    RuntimeConfig cfg = store.getConfig();
+    cfg.readerProfile = 2;
+    store.setConfig(cfg);
+    EEPROM.update(OFF_PROFILE, 2);
+    EEPROM.update(OFF_PROFILE + 1, (uint8_t)~2);
+
+    memcpy(fullImage, EEPROM.image(), sizeof(fullImage));
+}
+
+// Ce qu'a laissé un firmware en version N : rien après sa dernière zone
+static void loadVersionImage(uint16_t version) {
+    uint8_t img[EEPROMClass::SIZE];
+    memcpy(img, fullImage, sizeof(img));
+    memset(img + areaEnd(version), 0xFF, OFF_CRC - areaEnd(version));
+    EEPROM.load(img, sizeof(img));
+    setVersion(version);
+}
+
+static void assertMigratedFrom(uint16_t version, long cutAt) {
+    char where[56];
+    snprintf(where, sizeof(where), "depuis v%u, coupure après %ld écritures", version, cutAt);
+
+    EEPROMStore store;
+    store.begin();
+    TEST_ASSERT_EQUAL_MESSAGE(EEPROM_VERSION, storedVersion(), where);
+    TEST_ASSERT_EQUAL_MESSAGE(BADGE_COUNT, store.getBadgeCount(), where);
+    TEST_ASSERT_EQUAL_MESSAGE(version >= 3 ? 2 : RFID_PROFILE_DEFAULT,
+                              store.getConfig().readerProfile, where);
+
+    uint8_t supervisor = version >= 6 ? EEPROMStore::ROLE_SUPERVISOR : 0;
+    TEST_ASSERT_EQUAL_MESSAGE(EEPROMStore::ROLE_USER | supervisor, store.getBadgeRoles(0), where);
+    for (uint8_t i = 1; i < BADGE_COUNT; i++) {
+        TEST_ASSERT_EQUAL_MESSAGE(EEPROMStore::ROLE_USER, store.getBadgeRoles(i), where);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(0, store.getBadgeRoles(BADGE_COUNT), where);
+
+    uint8_t expected[EEPROMStore::SCHEDULE_BITMAP_SIZE];
+    uint8_t got[EEPROMStore::SCHEDULE_BITMAP_SIZE];
+    for (uint8_t t = 1; t <= SCHEDULE_TEMPLATES; t++) {
+        if (t == 2 && version >= 4) memcpy(expected, bitmap, sizeof(expected));
+        else memset(expected, 0, sizeof(expected));
+        store.readScheduleTemplate(t, got);
+        TEST_ASSERT_EQUAL_MESSAGE(0, memcmp(expected, got, sizeof(got)), where);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(0, store.getBadgeSchedule(0), where);
+    TEST_ASSERT_EQUAL_MESSAGE(version >= 4 ? 2 : 0, store.getBadgeSchedule(1), where);
+
+    uint8_t failures, level;
+    TEST_ASSERT_TRUE_MESSAGE(store.readLockout(1, failures, level), where);
+    TEST_ASSERT_EQUAL_MESSAGE(0, failures + level, where);
+}
+
+// Redémarrage après coupure : tout doit être là, en version courante
+static void assertMigrated(long cutAt) {
+    char where[48];
+    snprintf(where, sizeof(where), "coupure après %ld écritures", cutAt);
+
+    EEPROMStore store;
+    store.begin();
+    TEST_ASSERT_EQUAL_MESSAGE(EEPROM_VERSION, storedVersion(), where);
+    TEST_ASSERT_EQUAL_MESSAGE(BADGE_COUNT, store.getBadgeCount(), where);
+    for (uint8_t i = 0; i < BADGE_COUNT; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(store.badgeExists(BADGES[i]), where);
+    }
+
+    uint8_t failures, level;
+    TEST_ASSERT_TRUE_MESSAGE(store.readLockout(0, failures, level), where);
+    TEST_ASSERT_EQUAL_MESSAGE(0, failures + level, where);
+}
+
+void setUp() {
+    EEPROM.cutPowerAfter(-1);
+}
+
+void tearDown() {
+    EEPROM.cutPowerAfter(-1);
+}
+
+void test_migration_without_cut() {
+    EEPROM.load(prevImage, sizeof(prevImage));
+    assertMigrated(-1);
+}
+
+// Coupure pile entre l'écriture de version et celle du CRC
+void test_cut_between_version_and_crc() {
+    EEPROM.load(prevImage, sizeof(prevImage));
+    uint32_t before = EEPROM.getWrites();
+    {
+        EEPROMStore store;
+        store.begin();
+    }
+    uint32_t total = EEPROM.getWrites() - before;
+    uint8_t crcBytes = (EEPROM.read(OFF_CRC) != prevImage[OFF_CRC]) +
+                       (EEPROM.read(OFF_CRC + 1) != prevImage[OFF_CRC + 1]);
+    TEST_ASSERT_GREATER_THAN(0, crcBytes);
+
+    long cutAt = (long)(total - crcBytes);
+    EEPROM.load(prevImage, sizeof(prevImage));
+    EEPROM.cutPowerAfter(cutAt);
+    {
+        EEPROMStore store;
+        store.begin();
+    }
+    EEPROM.cutPowerAfter(-1);
+    TEST_ASSERT_EQUAL(EEPROM_VERSION, storedVersion());   // version écrite, CRC non
+    assertMigrated(cutAt);
+}
+
+// Toute coupure avant la fin du CRC : étape rejouée, CRC de la version
+// précédente ou CRC à moitié écrit
+void test_cut_anywhere() {
+    EEPROM.load(prevImage, sizeof(prevImage));
+    uint32_t before = EEPROM.getWrites();
+    {
+        EEPROMStore store;
+        store.begin();
+    }
+    uint32_t total = EEPROM.getWrites() - before;
+
+    for (long cutAt = 0; cutAt < (long)total; cutAt++) {
+        EEPROM.load(prevImage, sizeof(prevImage));
+        EEPROM.cutPowerAfter(cutAt);
+        {
+            EEPROMStore store;
+            store.begin();
+        }
+        EEPROM.cutPowerAfter(-1);
+        assertMigrated(cutAt);
+    }
+}
+
+void test_every_version() {
+    for (uint16_t version = 1; version < EEPROM_VERSION; version++) {
+        loadVersionImage(version);
+        assertMigratedFrom(version, -1);
+    }
+}
+
+// Toute la chaîne depuis chaque version, coupée à chaque écriture
+void test_every_version_cut_anywhere() {
+    for (uint16_t version = 1; version < EEPROM_VERSION; version++) {
+        loadVersionImage(version);
+        uint32_t before = EEPROM.getWrites();
+        {
+            EEPROMStore store;
+            store.begin();
+        }
+        uint32_t total = EEPROM.getWrites() - before;
+
+        for (long cutAt = 0; cutAt < (long)total; cutAt++) {
+            loadVersionImage(version);
+            EEPROM.cutPowerAfter(cutAt);
+            {
+                EEPROMStore store;
+                store.begin();
+            }
+            EEPROM.cutPowerAfter(-1);
+            assertMigratedFrom(version, cutAt);
+        }
+    }
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    buildPrevImage();
+    for (uint8_t i = 0; i < sizeof(bitmap); i++) bitmap[i] = (i % 6 == 2) ? 0xF0 : 0;
+    buildFullImage();
+    RUN_TEST(test_migration_without_cut);
+    RUN_TEST(test_cut_between_version_and_crc);
+    RUN_TEST(test_cut_anywhere);
+    RUN_TEST(test_every_version);
+    RUN_TEST(test_every_version_cut_anywhere);
+    return UNITY_END();
+}
@@ -0,0 +1,87 @@
+/*
+  test_latency_trace — fenêtre badge -> relais remplie par le firmware
+  - Firmware complet (setup()/loop()) sur la carte simulée, horloge virtuelle.
+  - Badge ajouté au clavier (PIN admin, commande 11, badge présenté), puis
+    présenté à nouveau : la porte s'ouvre et LatencyTrace::finish() doit
+    ajouter un échantillon. Un refus n'en ajoute pas.
+  - Régression : VALIDATE_BADGE effaçait l'action OPEN_DOOR posée par la FSM,
+    la fenêtre restait vide.
+
+  pio test -e native_test -f test_latency_trace
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "config.h"
+#include "hal/linux/SimBoard.h"
+#include "trace/LatencyTrace.h"
+
+void setup();
+void loop();
+
+// Câblage du clavier et trace définis par le firmware (main.cpp)
+extern char keys[];
+extern byte rowPins[];
+extern byte colPins[];
+extern LatencyTrace trace;
+
+static const uint8_t KNOWN[] = { 0x04, 0xA1, 0x22, 0x3B, 0x10 };
+static const uint8_t UNKNOWN[] = { 0x04, 0x5C, 0x91, 0x07, 0x2E };
+
+static void runFor(unsigned long ms) {
+    unsigned long start = millis();
+    while (millis() - start < ms) {
+        loop();
+        sim::onLoop();
+    }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_window_empty_after_boot() {
+    TEST_ASSERT_EQUAL(0, trace.sampleCount());
+}
+
+// Ajout au clavier : aucune ouverture, donc aucun échantillon
+void test_add_badge_records_nothing() {
+    sim::typeKeys(DEFAULT_ADMIN_PIN "#");
+    runFor(1500);
+    sim::typeKeys("11#");
+    runFor(1500);
+    sim::tapCard(0, KNOWN, sizeof(KNOWN));
+    runFor(1000);
+    TEST_ASSERT_EQUAL(0, trace.sampleCount());
+}
+
+void test_denied_badge_records_nothing() {
+    sim::tapCard(0, UNKNOWN, sizeof(UNKNOWN));
+    runFor(1000);
+    TEST_ASSERT_EQUAL(0, trace.sampleCount());
+}
+
+void test_granted_badge_fills_window() {
+    for (uint8_t i = 1; i <= 3; i++) {
+        sim::tapCard(0, KNOWN, sizeof(KNOWN));
+        runFor(1000);
+        TEST_ASSERT_EQUAL(i, trace.sampleCount());
+    }
+    TEST_ASSERT_GREATER_THAN(0, trace.percentile(50));
+    TEST_ASSERT_LESS_OR_EQUAL(trace.percentile(99), trace.percentile(50));
+}
+
+int main(int, char **) {
+    sim::useVirtualClock(true);
+    sim::setVerbose(false);
+    sim::setKeypad(keys, rowPins, colPins, SIM_KEYPAD_ROWS, SIM_KEYPAD_COLS);
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_window_empty_after_boot);
+    RUN_TEST(test_add_badge_records_nothing);
+    RUN_TEST(test_denied_badge_records_nothing);
+    RUN_TEST(test_granted_badge_fills_window);
+    return UNITY_END();
+}
@@ -0,0 +1,136 @@
+/*
+  test_soak_auth — chemin clavier / authentification admin sans tas
+  - Firmware complet (setup()/loop()) sur la carte simulée, horloge virtuelle.
+  - Cycles clavier : PIN admin puis commande 10 (ouverture porte 0).
+  - Cycles série : même échange en JSON ({"cmd":"123"} puis {"cmd":"10"}),
+    plus les diagnostics immédiats "stats" et "mem".
+  - Boucle serrée sur KeypadModule : vérification (bon / mauvais PIN),
+    changement de PIN et lecture de commande, SOAK_PIN_CHECKS fois.
+  - Tas mesuré par mallinfo2() (glibc) après un tour de chauffe : ni octets
+    en plus (fuite) ni arène agrandie (fragmentation) à la fin.
+    Sous sanitizers, malloc est intercepté : mesure sans objet.
+
+  pio test -e native_test -f test_soak_auth
+*/
+
+#include <Arduino.h>
+#include <unity.h>
+#include <malloc.h>
+
+#include "config.h"
+#include "fsm/FSMController.h"
+#include "hal/linux/SimBoard.h"
+#include "keypad/KeypadModule.h"
+
+#ifndef SOAK_CYCLES
+#define SOAK_CYCLES 200          // échanges complets par source (setup()/loop())
+#endif
+#ifndef SOAK_PIN_CHECKS
+#define SOAK_PIN_CHECKS 1000000UL
+#endif
+#define SOAK_MAX_LOOPS 200000    // garde-fou par échange (FSM bloquée)
+
+void setup();
+void loop();
+
+// Câblage du clavier, clavier et FSM définis par le firmware (main.cpp)
+extern char keys[];
+extern byte rowPins[];
+extern byte colPins[];
+extern KeypadModule keypad;
+extern FSMController fsm;
+
+struct HeapUse {
+    size_t inUse;
+    size_t arena;
+};
+
+static HeapUse heapUse() {
+    struct mallinfo2 mi = mallinfo2();
+    HeapUse h = { mi.uordblks, mi.arena };
+    return h;
+}
+
+static void assertNoGrowth(const HeapUse &before) {
+    HeapUse after = heapUse();
+    TEST_ASSERT_EQUAL_MESSAGE(before.inUse, after.inUse, "octets alloués");
+    TEST_ASSERT_EQUAL_MESSAGE(before.arena, after.arena, "taille de l'arène");
+}
+
+// Jusqu'au retour au repos : frappes jouées, FSM en IDLE sans action
+static void runUntilIdle() {
+    unsigned long n = 0;
+    do {
+        loop();
+        sim::onLoop();
+        n++;
+    } while ((!sim::idle() || sim::serialPending() > 0 ||
+              fsm.getState() != SystemState::IDLE || fsm.getAction() != FSMAction::NONE) &&
+             n < SOAK_MAX_LOOPS);
+    TEST_ASSERT_LESS_THAN(SOAK_MAX_LOOPS, n);
+}
+
+static void keypadCycle() {
+    sim::typeKeys(DEFAULT_ADMIN_PIN "#");
+    runUntilIdle();
+    sim::typeKeys("10#");
+    runUntilIdle();
+}
+
+static void serialSend(const char *line) {
+    sim::injectSerial((const uint8_t *)line, strlen(line));
+    runUntilIdle();
+}
+
+static void serialCycle() {
+    serialSend("{\"id\":\"s1\",\"cmd\":\"" DEFAULT_ADMIN_PIN "\"}\n");
+    serialSend("{\"id\":\"s2\",\"cmd\":\"10\"}\n");
+    serialSend("{\"id\":\"s3\",\"cmd\":\"stats\"}\n");
+    serialSend("{\"id\":\"s4\",\"cmd\":\"mem\"}\n");
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_keypad_cycles() {
+    keypadCycle();
+    HeapUse before = heapUse();
+    for (unsigned i = 0; i < SOAK_CYCLES; i++) keypadCycle();
+    assertNoGrowth(before);
+}
+
+void test_serial_cycles() {
+    serialCycle();
+    HeapUse before = heapUse();
+    for (unsigned i = 0; i < SOAK_CYCLES; i++) serialCycle();
+    assertNoGrowth(before);
+}
+
+void test_pin_checks() {
+    static const char *const PINS[] = { DEFAULT_ADMIN_PIN, "4567" };
+    char cmd[KeypadModule::MAX_INPUT + 1];
+    HeapUse before = heapUse();
+    for (unsigned long i = 0; i < SOAK_PIN_CHECKS; i++) {
+        TEST_ASSERT_TRUE(keypad.checkAdminPIN(PINS[i & 1]));
+        TEST_ASSERT_FALSE(keypad.checkAdminPIN((i & 1) ? "45678" : " 12 "));
+        TEST_ASSERT_TRUE(keypad.changeAdminPIN(PINS[(i + 1) & 1]));
+        keypad.getCommand(cmd, sizeof(cmd));
+    }
+    keypad.changeAdminPIN(DEFAULT_ADMIN_PIN);
+    assertNoGrowth(before);
+}
+
+int main(int, char **) {
+    sim::useVirtualClock(true);
+    sim::setReplay(true);      // RX série pris dans injectSerial(), pas de pty
+    sim::setVerbose(false);
+    sim::setKeypad(keys, rowPins, colPins, SIM_KEYPAD_ROWS, SIM_KEYPAD_COLS);
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_keypad_cycles);
+    RUN_TEST(test_serial_cycles);
+    RUN_TEST(test_pin_checks);
+    return UNITY_END();
+}